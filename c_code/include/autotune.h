@@ -0,0 +1,36 @@
+#ifndef AUTOTUNE_H
+#define AUTOTUNE_H
+
+// Relay-feedback autotuning of the wheel velocity loops
+//
+// Phases (both wheels at once):
+//   1. Run at max PWM to measure top speed
+//   2. Run at the bias PWM (midpoint of min/max) to find the relay setpoint
+//   3. Relay between min and max PWM around that setpoint and measure the
+//      oscillation amplitude and period (ultimate gain Ku and period Pu)
+// Gains use Tyreus-Luyben PI tuning and are saved to PARAMS_FILE.
+//
+// Lifted mode runs both wheels forward; floor mode spins in place
+// (left forward, right reverse) so the robot does not travel.
+
+#define AUTOTUNE_MAX_SEC 1.5        // Phase 1 duration
+#define AUTOTUNE_BIAS_SEC 1.5       // Phase 2 duration
+#define AUTOTUNE_AVERAGE_SEC 0.5    // Averaging window at the end of phases 1 and 2
+#define AUTOTUNE_RELAY_MAX_SEC 10.0 // Give up if the relay does not oscillate
+#define AUTOTUNE_RELAY_CYCLES 8     // Cycles to record
+#define AUTOTUNE_SKIP_CYCLES 2      // Initial cycles discarded while settling
+#define AUTOTUNE_HYSTERESIS 0.05    // Relay hysteresis as a fraction of setpoint speed
+
+typedef enum {
+    AUTOTUNE_LIFTED = 0,
+    AUTOTUNE_FLOOR = 1
+} AutotuneMode;
+
+// Start autotune in a background thread. Returns -1 if already running.
+// Call start and abort from one thread (the command thread).
+int autotune_start(AutotuneMode mode, int min_pwm, int max_pwm);
+// Stop a running autotune and wait for its thread to exit. Do not hold a motor lock.
+void autotune_abort(void);
+int autotune_active(void);
+
+#endif
@@ -27,6 +27,25 @@
 #define START_Y 15.0
 #define START_HEADING 0.0
 
+// Heading convention: degrees from +X toward +Y (x += d cos h, y += d sin h).
+// imu_read_gyro_z() negates the MPU6050 z rate, which is counterclockwise-positive
+// with the chip facing up. So with the IMU mounted chip-up, heading grows clockwise
+// seen from above and a turn with the left wheel forward raises it.
+// Not yet confirmed on the robot: a turn that heads the wrong way stops the GOTO
+// (TURN_WRONG_WAY_DEG in control.h). Set -1 if the IMU is mounted chip-down.
+#define TURN_LEFT_FORWARD_SIGN 1
+
+// Odometry uncertainty model (position variance in ft^2, see landmark.h)
+#define ODOM_INITIAL_VAR (0.25 * 0.25)   // Hand placement at the start position
+#define ODOM_VAR_PER_FOOT 0.01           // Growth per foot driven (~0.55 ft 1-sigma after 30 ft)
+#define ODOM_VAR_PER_DEG 0.0005          // Growth per degree turned (heading error -> cross-track error)
+
+// Gyro is integrated only while the wheels are moving: either wheel more than
+// ODOM_MOTION_COUNTS from where it last moved, within ODOM_MOTION_HOLD_SEC.
+// Counted over time, not per cycle, so a slow coast out of a turn still counts
+#define ODOM_MOTION_COUNTS 3
+#define ODOM_MOTION_HOLD_SEC 0.1
+
 
 // Time utilities
 // Time utilities
@@ -43,6 +62,7 @@ typedef struct {
     double heading;     // degrees
     int32_t last_left_total;
     int32_t last_right_total;
+    double pos_var;     // Position variance (ft^2), grown by dead reckoning, shrunk by landmarks
 } OdometryState;
 
 // Navigation State Machine State
@@ -61,6 +81,14 @@ typedef struct {
     double target_heading;  // For TURN state
     double target_distance; // For DRIVE state
     double speed_multiplier; // 0.0 to 1.0 from slider
+    int target_landmark;    // Landmark at the GOTO target (-1 if none), contact there counts as arrival
+    int arrival;            // ArrivalMode of the GOTO target (control.h)
+    double settle_since;    // wheels_settled() state
+    int first_move;         // No move of this GOTO started yet
+    double leg_speed;       // Drive speed cap of this GOTO below the slider (speed_multiplier), 0 = none
+    double leg_accel;       // PWM ramp of this GOTO (percent/sec), 0 = none
+    double turn_start_heading; // Heading the current turn started from (turn_wrong_way)
+    int32_t drive_lead;     // Counts the left wheel is kept ahead of the right on this drive (drive_steer)
 } NavigationController;
 
 #endif
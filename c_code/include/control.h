@@ -0,0 +1,131 @@
+#ifndef CONTROL_H
+#define CONTROL_H
+
+#include "motor.h"
+#include "params.h"
+
+// Velocity estimate filtering
+#define VELOCITY_WINDOW_SEC 0.005     // Minimum time between velocity samples
+#define VELOCITY_FILTER_ALPHA 0.3     // IIR smoothing (1.0 = no filtering)
+#define VELOCITY_LAG_SEC 0.014        // Age of the estimate: (1 - alpha) / alpha windows plus half a window
+
+// Update enc->velocity from the current position (caller holds the motor lock)
+void update_encoder_velocity(EncoderState *enc, double timestamp);
+
+// 1 if autotune has produced velocity loop gains for this wheel
+int velocity_loop_tuned(const WheelParams *wp);
+
+// Reset loop state at the start of a move
+void velocity_loop_reset(EncoderState *enc);
+
+// PI wheel speed control with model feed-forward
+// Returns speed percent (-100 to 100) for set_motor_speed()
+int velocity_loop_update(EncoderState *enc, const WheelParams *wp, double target_speed, double now);
+
+// --- Move execution (control thread and asgc_batch_sim) ---
+// Pure functions of their arguments, so the simulator runs the same logic per robot
+
+#define SETTLE_SPEED 150.0         // Wheel speed (counts/sec) that counts as stopped
+#define SETTLE_TIME_SEC 0.1        // Both wheels stopped this long = settled
+
+// How a GOTO target is reached (goto x y [precise|pass])
+typedef enum {
+    ARRIVE_PRECISE = 0,    // Final target: plan and arrive only from a settled robot
+    ARRIVE_PASS = 1        // Waypoint: arrive as soon as the coast will end in tolerance
+} ArrivalMode;
+
+typedef struct {
+    const char *name;
+    double distance_ft;    // Arrived when the predicted stopping point is this close
+    double heading_deg;    // Turn first if heading is off by more
+    int settle;            // Wait for the wheels to stop before planning the next move
+} ArrivalProfile;
+
+extern const ArrivalProfile arrival_profiles[];
+
+// Profile index for a name ("precise", "pass"), -1 if unknown
+int arrival_find(const char *name);
+
+// Per-leg limits of a move (goto x y [profile] [speed] [accel])
+typedef struct {
+    int max_pwm;           // Speed-scaled PWM cap (at least min_pwm)
+    int pwm_limit;         // Configured maximum (g_max_pwm), velocity loop cruise scale
+    int min_pwm;           // Ramp start, the wheels barely move below it (g_min_pwm)
+    double accel;          // PWM cap ramp from min_pwm (percent/sec from move start), 0 = none
+    int settle;            // Move ends stopped at the target, not just coasting into it
+} MoveLimits;
+
+// Limits for a leg: speed multiplier (0-1) of pwm_limit, never below min_pwm
+MoveLimits move_limits(int min_pwm, int pwm_limit, double speed, double accel, int settle);
+
+// Pulse width (ns) for a speed percent (-100 to 100), before ESC shaping
+int pulse_from_percent(int speed_percent);
+
+// Wheel counts for an in-place turn of the given angle (absolute value)
+int32_t calculate_turn_counts(double degrees);
+
+// Signed left wheel counts of an in-place turn by heading_diff degrees
+// (TURN_LEFT_FORWARD_SIGN); the right wheel moves the negative
+int32_t turn_left_counts(double heading_diff);
+
+#define TURN_WRONG_WAY_DEG 15.0   // Heading moved this far against a turn: the turn sign is wrong
+
+// 1 if the heading has moved more than TURN_WRONG_WAY_DEG away from
+// target_heading, against the turn that started at start_heading
+int turn_wrong_way(double start_heading, double target_heading, double heading);
+
+// Start a relative move of counts on one wheel
+void wheel_move_start(EncoderState *enc, int32_t counts, double now);
+
+// Counts travelled since the current move started
+int32_t wheel_move_position(const EncoderState *enc);
+
+// Remaining counts of the current move
+int32_t wheel_move_error(const EncoderState *enc);
+
+// Steady wheel speed (counts/sec, signed) for a speed percent, from the
+// identified gain and deadband; 0 without a model
+double wheel_model_speed(const WheelParams *wp, int speed_percent);
+
+// Further travel (counts, signed) if the wheel were released now: dead time,
+// then coasting down at coast_decel. A wheel still speeding up under
+// enc->move_pwm keeps accelerating through the dead time, from a speed the
+// filtered estimate trails by VELOCITY_LAG_SEC
+double wheel_stop_distance(const EncoderState *enc, const WheelParams *wp);
+
+// One control step of a wheel move. Writes the speed percent to *pwm (0 once
+// done, or while coasting into the target) and returns 1 when the wheel has
+// reached its target: stopped within STOP_THRESHOLD if limits->settle is set,
+// otherwise as soon as its predicted stop is.
+int wheel_move_step(EncoderState *enc, const WheelParams *wp, const MoveLimits *limits, double now, int *pwm);
+
+#define MOVE_STALL_LIMIT 4        // Stall checks (0.5 s each) without progress before a move is given up
+
+#define DRIVE_SYNC_COUNTS 50      // Drive: a wheel this far ahead of the other coasts (~0.7 deg)
+
+// Straight drives (both wheels the same target): 1 if the wheel with
+// `error` counts left is more than DRIVE_SYNC_COUNTS ahead of the other,
+// so a speed mismatch between the wheels doesn't curve the path. To keep
+// one wheel a lead ahead, offset its error by the lead
+int drive_sync_hold(int32_t error, int32_t other_error, int32_t target);
+
+#define DRIVE_STEER_MIN_FT 1.5    // Drive: steer onto the target until this close, then only keep the wheels level
+
+// Drives: counts the left wheel should gain on the right to bring the heading
+// onto (target_x, target_y), as for a turn of the heading error. Wheel sizes
+// differ, so level counts alone still curve the path. Returns 1 with *lead set,
+// 0 within DRIVE_STEER_MIN_FT, where the bearing swings with every inch
+int drive_steer(const OdometryState *odom, double target_x, double target_y, int32_t *lead);
+
+// Tracks how long both wheels have been below SETTLE_SPEED (*still_since is
+// -1 while moving). Returns 1 once they have been for SETTLE_TIME_SEC.
+int wheels_settled(double *still_since, double left_velocity, double right_velocity, double now);
+
+// GOTO planner: next leg from the current pose. coast_ft is how far the robot
+// will still roll along its heading; arrival is judged from that stopping
+// point, moves from the current pose. Returns NAV_IDLE (arrived),
+// NAV_TURNING (*heading_diff set) or NAV_DRIVING (*distance set)
+NavState goto_plan(const OdometryState *odom, double coast_ft, double target_x, double target_y,
+                   const ArrivalProfile *profile, double *heading_diff, double *distance);
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef ESC_H
+#define ESC_H
+
+#include "params.h"
+
+// ESC reversal behavior (esc.mode in the parameter file)
+typedef enum {
+    ESC_MODE_DIRECT = 0,   // Reverses as soon as a reverse pulse arrives
+    ESC_MODE_NEUTRAL = 1,  // Needs a neutral dwell before it accepts reverse
+    ESC_MODE_BRAKE = 2     // Reverse pulse brakes first, then neutral dwell, then reverse (car ESC)
+} EscMode;
+
+typedef enum {
+    ESC_DRIVE = 0,         // Passing the commanded pulse through
+    ESC_BRAKING,           // Brake pulse until stopped or brake_time elapsed
+    ESC_NEUTRAL_DWELL      // Neutral until the ESC releases its direction lockout
+} EscPhase;
+
+// Per-ESC direction-change state machine
+typedef struct {
+    EscPhase phase;
+    int engaged_dir;       // Direction the ESC is latched in (-1, 0, 1)
+    double phase_start;    // Time the current BRAKING/NEUTRAL_DWELL phase began
+    double neutral_since;  // Time the output went neutral (-1 while driving)
+} EscShaper;
+
+// Direction of a pulse width: 1 forward, -1 reverse, 0 neutral (10us hysteresis)
+int esc_pulse_dir(int pulse_ns);
+
+void esc_reset(EscShaper *esc);
+
+// Shape the pulse sent to the ESC so direction changes go through the
+// brake/neutral sequence the ESC needs. Returns the pulse to output.
+int esc_shape(EscShaper *esc, const EscParams *p, int target_pulse_ns, double wheel_velocity, double now);
+
+// Record a pulse written without esc_shape() (e.g. raw joystick pulses)
+void esc_track_output(EscShaper *esc, int pulse_ns, double now);
+
+#endif
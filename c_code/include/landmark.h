@@ -0,0 +1,64 @@
+#ifndef LANDMARK_H
+#define LANDMARK_H
+
+#include "common.h"
+
+// Known course positions (must match BUCKETS in course_config.py)
+#define LANDMARK_COUNT 4
+
+// Robot center to bucket center when the front bumper touches a bucket (feet)
+#define LANDMARK_CONTACT_OFFSET_FT 1.0
+// Variance of the contact position (ft^2): bucket size and where on the bumper it hits
+#define LANDMARK_MEAS_VAR (0.3 * 0.3)
+
+// Observations further than this many sigmas from the odometry pose are rejected
+#define LANDMARK_GATE_SIGMA 3.0
+// Hard limit on a single correction (feet), whatever the uncertainty says
+#define LANDMARK_MAX_CORRECTION_FT 3.0
+// A contact whose odometry pose is this close to the contact offset is the
+// target bucket even if the fix is gated out: arrival without a correction (feet)
+#define LANDMARK_ARRIVAL_SLACK_FT 0.5
+// A GOTO target this close to a landmark is "drive to that landmark" (feet)
+#define LANDMARK_TARGET_RADIUS_FT 1.5
+
+// Contact detection: both wheels driven but slower than this for LANDMARK_STALL_TIME
+#define LANDMARK_STALL_SPEED 150.0   // counts/sec
+#define LANDMARK_MOVING_SPEED 400.0  // counts/sec, wheel must have reached this first
+#define LANDMARK_STALL_TIME 0.3      // seconds
+
+typedef struct {
+    const char *name;
+    double x;  // feet
+    double y;  // feet
+} Landmark;
+
+extern const Landmark landmarks[LANDMARK_COUNT];
+
+// Bucket contact detector (one per drive leg)
+typedef struct {
+    int moving;           // Both wheels have been up to speed this leg
+    double stalled_since; // Time both wheels dropped below stall speed (-1 if not stalled)
+} ContactDetector;
+
+// Landmark index from a name ("red") or index ("0"), -1 if unknown
+int landmark_find(const char *id);
+
+// Landmark at (x, y) within LANDMARK_TARGET_RADIUS_FT, -1 if none
+int landmark_at(double x, double y);
+
+// Grow position variance for an odometry step (distance in feet, turn in degrees)
+void odometry_grow_variance(OdometryState *odom, double distance, double turn_deg);
+
+// Apply a contact observation of landmark id: the robot center is
+// LANDMARK_CONTACT_OFFSET_FT behind the landmark along the current heading.
+// Kalman-weighted by odom->pos_var and gated. Returns 1 if applied (correction
+// written to dx/dy), 0 if rejected (innovation written to dx/dy).
+int landmark_correct(OdometryState *odom, int id, double *dx, double *dy);
+
+void contact_reset(ContactDetector *cd);
+
+// Feed both wheel speeds each control cycle while driving forward.
+// Returns 1 once the robot has stopped against something.
+int contact_update(ContactDetector *cd, double left_velocity, double right_velocity, double now);
+
+#endif
@@ -4,6 +4,7 @@
 #include <pthread.h>
 #include <stdint.h>
 #include "common.h" // For OdometryState and NavigationController
+#include "esc.h"
 
 // PWM Configuration
 #define PWM_CHANNEL_LEFT 0   // GPIO 12 
@@ -24,6 +25,7 @@ typedef struct {
     int current_speed;
     int last_pulse_ns;           // For ramp rate limiting (in nanoseconds)
     double last_speed_update_time;  // For ramp rate limiting
+    EscShaper esc;               // Direction-change sequencing (brake/neutral/reverse)
     pthread_mutex_t lock;
 } Motor;
 
@@ -40,12 +42,24 @@ typedef struct {
 
     int32_t target_counts;     // Target relative distance
     int32_t move_start_counts; // Total counts at start of current move (for relative tracking)
+    double move_start_time;    // Time the current move started (acceleration ramp)
     int has_target;            // Flag
+    int move_pwm;              // Speed percent the move drives the wheel with (0 while coasting)
 
     // Stall detection
     int32_t stall_last_position; // Position at last stall check
     double stall_check_time;     // Time of last stall check
     int stall_count;             // Number of consecutive stalls
+
+    // Wheel velocity estimate (updated by encoder feedback thread)
+    double velocity;             // Filtered wheel speed (counts/sec)
+    double velocity_time;        // Timestamp of last velocity sample
+    int32_t velocity_position;   // Position at last velocity sample
+
+    // Velocity loop state (used when gains are tuned, see control.h)
+    double vel_integral;         // Integrated speed error (percent)
+    double vel_last_time;        // Time of last loop update
+    double vel_last_target;      // Last target speed, integral resets on sign change
 } EncoderState;
 
 // Global arrays
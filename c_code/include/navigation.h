@@ -0,0 +1,43 @@
+#ifndef NAVIGATION_H
+#define NAVIGATION_H
+
+#include "common.h"
+#include "motor.h"
+#include "params.h"
+#include "landmark.h"
+
+// --- GOTO state machine (control thread and asgc_batch_sim) ---
+// One step of NAV_GOTO / NAV_TURNING / NAV_DRIVING per control cycle. The
+// caller owns the I/O: it applies the wheel speeds and reports the events,
+// so the simulator runs exactly the controller's navigation per robot.
+
+// What happened in a step (NavStep.events)
+#define NAV_EVENT_TURN      0x01   // Turn move started (heading_diff)
+#define NAV_EVENT_DRIVE     0x02   // Drive move started (distance)
+#define NAV_EVENT_MOVE_DONE 0x04   // Both wheels reached their move target, back to NAV_GOTO
+#define NAV_EVENT_ARRIVED   0x08   // GOTO finished, state is NAV_IDLE
+#define NAV_EVENT_LANDMARK  0x10   // Bucket contact applied as a position fix (dx, dy), with ARRIVED
+#define NAV_EVENT_REJECTED  0x20   // Bucket contact rejected as a fix (innovation in dx, dy); with ARRIVED if at the bucket
+#define NAV_EVENT_WRONG_WAY 0x40   // Turn ran away from its target (turn_wrong_way), GOTO stopped
+#define NAV_EVENT_STALLED   0x80   // Move stuck for MOVE_STALL_LIMIT stall checks, GOTO stopped
+
+typedef struct {
+    int events;
+    int pwm[2];            // Wheel speed percent (-100 to 100) to apply this cycle
+    int stalled[2];        // Wheel stall count went up this cycle
+    double heading_diff;   // NAV_EVENT_TURN
+    double distance;       // NAV_EVENT_DRIVE
+    double dx, dy;         // NAV_EVENT_LANDMARK, NAV_EVENT_REJECTED
+} NavStep;
+
+// Start a GOTO to (x, y) with its leg limits (goto x y [arrival] [speed] [accel])
+void nav_start_goto(NavigationController *nav, double x, double y, int arrival, double speed, double accel);
+
+// Advance the GOTO by one control cycle. enc/params are both wheels (the
+// caller holds both motor locks on the robot), contact is the bucket contact
+// detector of the current drive. Returns the new state.
+NavState nav_step(NavigationController *nav, ContactDetector *contact, EncoderState enc[2],
+                  OdometryState *odom, const MotorParams *params, int min_pwm, int max_pwm,
+                  double now, NavStep *out);
+
+#endif
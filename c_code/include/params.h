@@ -0,0 +1,47 @@
+#ifndef PARAMS_H
+#define PARAMS_H
+
+// Motor parameter file, written by tools/motor_sysid.py and the autotune command
+// Path is relative to the working directory (same convention as ../logs)
+#define PARAMS_FILE "../c_code/motor_params.conf"
+
+// Identified per-wheel plant model (first order plus dead time)
+// Keys in the file are prefixed with "left." or "right."
+typedef struct {
+    double deadband_ns;   // Pulse offset from neutral before the wheel moves (ns)
+    double gain;          // Steady-state speed per pulse offset beyond deadband (counts/sec per us)
+    double tau;           // Time constant (seconds)
+    double dead_time;     // Delay from pulse change to first response (seconds)
+    double coast_decel;   // Deceleration when coasting at neutral (counts/sec^2)
+
+    // Velocity loop (written by autotune, 0 gains = bang-bang control)
+    double vel_kp;        // Proportional gain (percent per counts/sec)
+    double vel_ki;        // Integral gain (percent per counts)
+    double max_speed;     // Wheel speed at g_max_pwm (counts/sec)
+    double ku;            // Relay test ultimate gain (percent per counts/sec)
+    double pu;            // Relay test ultimate period (seconds)
+} WheelParams;
+
+// ESC direction-change behavior (keys prefixed with "esc.", see esc.h)
+typedef struct {
+    double mode;          // EscMode: 0 = direct, 1 = neutral dwell, 2 = brake + neutral dwell
+    double brake_ns;      // Brake pulse offset from neutral, opposite the latched direction (ns)
+    double brake_time;    // Maximum brake duration before the neutral dwell (seconds)
+    double neutral_dwell; // Neutral time before the ESC accepts reverse (seconds)
+    double stop_speed;    // Wheel speed treated as stopped, ends braking early (counts/sec)
+} EscParams;
+
+typedef struct {
+    WheelParams wheel[2]; // 0 = left, 1 = right
+    EscParams esc;        // Shared by both ESCs
+    int loaded;           // 1 if values came from a parameter file
+} MotorParams;
+
+extern MotorParams motor_params;
+
+void params_set_defaults(MotorParams *p);
+int params_load(MotorParams *p, const char *path);   // Returns number of keys read, -1 if no file
+int params_save(const MotorParams *p, const char *path);
+void params_print(const MotorParams *p);
+
+#endif
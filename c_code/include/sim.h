@@ -0,0 +1,134 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+#include "common.h"
+#include "motor.h"
+#include "params.h"
+
+// Batch plant simulator for asgc_batch_sim
+// Structure-of-arrays: every field is an array over robots ("lanes"), so the
+// plant and sensor kernels vectorize across robots. The controller side
+// (navigation.c, control.c, esc.c) runs per lane on an EncoderState, like on the robot.
+// The buckets (landmarks) are obstacles: a robot touching one can't drive into it.
+
+#define SIM_DT 0.001f               // Plant and sensor step (encoder thread rate, seconds)
+#define SIM_CONTROL_DIV 5           // Control step every 5 plant steps (200 Hz)
+#define SIM_DELAY_STEPS 256         // Actuator dead-time ring (must cover dead_time + injected delay)
+#define SIM_LATENCY_STEPS 256       // Sensor history ring for injected sensor latency
+#define SIM_LANE_ALIGN 16           // Lane count padding (floats per 64-byte line)
+
+#define SIM_BRAKE_DECEL_SCALE 4.0f  // ESC brake deceleration relative to coasting
+#define SIM_GYRO_LSB_DPS (1.0f / 131.0f) // MPU6050 at +/-250 dps
+
+// Per-robot variation drawn at sim_init (1-sigma, relative unless noted)
+typedef struct {
+    float gain;           // Wheel gain spread
+    float deadband;       // Wheel deadband spread
+    float tau;            // Wheel time constant spread
+    float wheel_diameter; // True wheel diameter vs WHEEL_DIAMETER_INCHES
+    float gyro_bias;      // Residual gyro bias after calibration (deg/s)
+    float gyro_noise;     // Gyro white noise per sample (deg/s)
+    float encoder_noise;  // AS5600 reading noise (counts)
+} SimNoise;
+
+// Timing faults injected between the plant and the controller (seconds, probability).
+// Delays are whole SIM_DT steps; jitter adds a uniform 0..jitter on top per read/command.
+typedef struct {
+    float sensor_delay;     // Age of the samples the controller reads
+    float sensor_jitter;
+    float sensor_drop;      // A failed read: the controller keeps its previous sample
+    float actuator_delay;   // Time for a command to reach the ESC, on top of the wheel dead time
+    float actuator_jitter;  // A late write: the newest command is applied when it lands
+    float actuator_drop;    // A lost write: the ESC keeps the previous pulse
+} SimLatency;
+
+typedef struct {
+    int lanes;                  // Robots simulated (arrays are padded to SIM_LANE_ALIGN)
+    int padded;
+    float time;                 // Simulated time (seconds)
+    long step;
+
+    // Wheel model shared by all lanes (from motor_params.conf), per wheel
+    int delay_steps[2];
+    float coast_decel[2];
+    int esc_mode;
+    float esc_dwell;
+
+    // --- True plant (per wheel arrays are [wheel][lane]) ---
+    float *wheel_pos[2];        // Wheel angle (counts, unwrapped)
+    float *wheel_vel[2];        // Wheel speed (counts/sec)
+    float *esc_dir[2];          // Direction the simulated ESC is latched in (-1, 0, 1)
+    float *esc_neutral[2];      // Time the ESC input has been neutral (seconds)
+    float *cmd_hist[2];         // Commanded pulse offset ring [SIM_DELAY_STEPS][padded] (ns)
+    float *gain[2];             // counts/sec per us beyond deadband
+    float *deadband[2];         // ns
+    float *inv_tau[2];          // 1/seconds
+    float *feet_per_count[2];   // True travel per count (wheel diameter error)
+    float *x, *y;               // True pose (feet)
+    float *cos_th, *sin_th;     // True heading as a unit vector
+    float *gyro_bias;           // deg/s
+
+    // --- Sensors and estimator, mirroring encoder_feedback_thread ---
+    int32_t *raw[2];            // AS5600 raw angle (0-4095)
+    int32_t *last_raw[2];
+    int32_t *rotations[2];
+    int32_t *total[2];          // total_counts
+    float *velocity[2];         // update_encoder_velocity() estimate
+    float *vel_time[2];
+    int32_t *vel_pos[2];
+    float *gyro;                // Measured gyro rate (deg/s)
+    float *odom_x, *odom_y;     // update_odometry() state (feet)
+    float *odom_h;              // Heading (degrees 0-360)
+    float *odom_cos, *odom_sin; // Heading unit vector
+    int32_t *odom_last[2];
+    int32_t *odom_anchor[2];    // Counts where each wheel last moved (ODOM_MOTION_COUNTS)
+    float *odom_still;          // Time since the wheels last moved (s)
+
+    // --- Actuator input, written by the per-lane controller (sim_write_command) ---
+    float *cmd_pulse[2];        // Pulse offset from neutral (ns) after ESC shaping
+    float *cmd_pending[2];      // Jittered command still on its way
+    float *cmd_due;             // Time the pending command lands (-1 = none)
+
+    // --- Injected latency (sim_set_latency) ---
+    SimLatency latency;
+    int sensor_steps;           // Fixed sensor delay in steps
+    int sensor_jitter_steps;
+    int32_t *hist_total[2];     // Sensor history rings [SIM_LATENCY_STEPS][padded], NULL if unused
+    float *hist_velocity[2];
+    float *hist_odom[3];        // x, y, heading
+
+    uint32_t *rng;              // xorshift32 state per lane
+    uint32_t *fault_rng;        // Separate stream for injected faults
+    float gyro_noise;
+    float encoder_noise;
+} SimPlant;
+
+// Allocate and draw per-lane variation. Returns 0 on success, -1 on allocation failure.
+int sim_init(SimPlant *sim, int lanes, const MotorParams *params, const SimNoise *noise, uint32_t seed);
+void sim_free(SimPlant *sim);
+
+// Inject sensor/actuator latency. Call after sim_init, before sim_reset_pose.
+// Returns 0 on success, -1 if the delays are out of range or allocation fails.
+int sim_set_latency(SimPlant *sim, const SimLatency *latency);
+
+// Place every robot at a pose (feet, degrees) and reset sensors
+void sim_reset_pose(SimPlant *sim, double x, double y, double heading);
+
+// Advance the plant and sensors by SIM_DT
+void sim_step(SimPlant *sim);
+
+// Copy a lane's sensor readings (as delayed by the injected latency) into the
+// controller's encoder and odometry state. The position variance stays with the
+// controller and grows by the travel since the previous read (set it after the
+// first read). Returns 0 and leaves them untouched when the read is dropped.
+int sim_read_sensors(SimPlant *sim, int lane, EncoderState enc[2], OdometryState *odom);
+
+// Shift a lane's dead-reckoned position (feet), e.g. by a landmark correction
+// the controller applied to its copy, including samples still to be read
+void sim_correct_odometry(SimPlant *sim, int lane, double dx, double dy);
+
+// Send a lane's ESC pulses (offset from neutral, ns) through the actuator path
+void sim_write_command(SimPlant *sim, int lane, float left, float right);
+
+#endif
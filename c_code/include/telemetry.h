@@ -0,0 +1,60 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+
+// Control modes for logging
+typedef enum {
+    MODE_IDLE = 0,
+    MODE_JOYSTICK = 1,    // Direct pulse commands
+    MODE_VOICE_NAV = 2    // Autonomous goto commands
+} ControlMode;
+
+// One 200Hz telemetry sample
+// Layout is mirrored by ENTRY_DTYPE in tools/log_viewer.py (live mode)
+typedef struct {
+    double time;
+    int32_t target_l;
+    int32_t actual_l;
+    int pulse_l;
+    int raw_l;
+    int32_t target_r;
+    int32_t actual_r;
+    int pulse_r;
+    int raw_r;
+    char mode; // Control mode: 0=IDLE, 1=JOYSTICK, 2=VOICE_NAV
+
+    // IMU data
+    double gyro_z;        // Z-axis gyro rate (degrees/sec)
+
+    // Odometry data
+    double odom_x;        // X position (feet)
+    double odom_y;        // Y position (feet)
+    double odom_heading;  // Heading (degrees)
+
+    // Navigation state
+    char nav_state;       // 0=IDLE, 1=TURNING, 2=DRIVING, 3=GOTO
+} LogEntry;
+
+// --- Live telemetry ring (file-backed mmap in RAM disk) ---
+// Readers map the file read-only and poll write_index; the newest entry
+// is at slot (write_index - 1) % capacity.
+#define TELEMETRY_RING_PATH "/dev/shm/asgc_telemetry"
+#define TELEMETRY_RING_CAPACITY 12000     // 60 seconds at 200Hz (~1MB)
+#define TELEMETRY_RING_MAGIC 0x43475341   // "ASGC" little-endian
+#define TELEMETRY_RING_VERSION 1
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entry_size;    // sizeof(LogEntry)
+    uint32_t capacity;      // Number of entry slots
+    uint64_t write_index;   // Total entries written (published after the entry)
+    uint8_t reserved[40];   // Pad header to 64 bytes
+} TelemetryRingHeader;
+
+int telemetry_ring_open(void);
+void telemetry_ring_push(const LogEntry *entry);
+void telemetry_ring_close(void);
+
+#endif
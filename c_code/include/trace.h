@@ -0,0 +1,16 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+// Timeline trace events, merged with the web server's trace by tools/trace_merge.py
+// Line format: <CLOCK_MONOTONIC seconds>\t<source>\t<event>\t<detail>
+// Enabled with the --trace command line flag (set by motor_interface.py when ASGC_TRACE=1)
+#define TRACE_CONTROLLER_PATH "/dev/shm/asgc_trace_controller.log"
+
+int trace_open(const char *path);
+void trace_close(void);
+int trace_enabled(void);
+
+// No-op unless trace_open() succeeded
+void trace_event(const char *event, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+#endif
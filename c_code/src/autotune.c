@@ -0,0 +1,228 @@
+#include "../include/autotune.h"
+#include "../include/motor.h"
+#include "../include/params.h"
+#include "../include/common.h"
+#include <stdio.h>
+#include <pthread.h>
+#include <math.h>
+
+static volatile int autotune_running = 0;
+static volatile int autotune_abort_flag = 0;
+static pthread_t autotune_tid;
+static int autotune_joinable = 0;  // Thread started and not yet joined
+
+static AutotuneMode tune_mode;
+static int tune_min_pwm;
+static int tune_max_pwm;
+
+static const char *wheel_names[2] = {"left", "right"};
+
+// Per-wheel relay test state (speeds are in the wheel's direction of travel)
+typedef struct {
+    int dir;              // +1 forward, -1 reverse
+    double max_speed;     // Phase 1 result
+    double setpoint;      // Phase 2 result
+    int relay_high;       // Current relay output
+    double last_switch;   // Time of last low -> high switch
+    double v_min;         // Speed extremes within the current cycle
+    double v_max;
+    int cycles;           // Completed cycles
+    double amp_sum;       // Sum of recorded half peak-to-peak amplitudes
+    double period_sum;    // Sum of recorded periods
+    int recorded;
+} RelayWheel;
+
+static double wheel_speed(int i) {
+    pthread_mutex_lock(&motors[i].lock);
+    double v = encoders[i].velocity;
+    pthread_mutex_unlock(&motors[i].lock);
+    return v;
+}
+
+static void wheel_output(int i, int pwm) {
+    pthread_mutex_lock(&motors[i].lock);
+    set_motor_speed(i, pwm, 1);
+    pthread_mutex_unlock(&motors[i].lock);
+}
+
+// Hold a fixed PWM and average the speed over the end of the phase
+// Returns -1 if aborted
+static int run_fixed_phase(RelayWheel w[2], int pwm, double duration, double result[2]) {
+    double start = get_time_sec();
+    double sum[2] = {0, 0};
+    int samples = 0;
+
+    while (!autotune_abort_flag) {
+        double elapsed = get_time_sec() - start;
+        if (elapsed >= duration) break;
+
+        for (int i = 0; i < 2; i++) wheel_output(i, w[i].dir * pwm);
+
+        if (elapsed >= duration - AUTOTUNE_AVERAGE_SEC) {
+            for (int i = 0; i < 2; i++) sum[i] += w[i].dir * wheel_speed(i);
+            samples++;
+        }
+        sleep_us(5000); // 200Hz, same as the control loop
+    }
+    if (autotune_abort_flag || samples == 0) return -1;
+
+    for (int i = 0; i < 2; i++) result[i] = sum[i] / samples;
+    return 0;
+}
+
+// Relay between min and max PWM around each wheel's setpoint speed
+static int run_relay_phase(RelayWheel w[2]) {
+    double start = get_time_sec();
+
+    while (!autotune_abort_flag) {
+        double now = get_time_sec();
+        if (now - start > AUTOTUNE_RELAY_MAX_SEC) break;
+        if (w[0].recorded >= AUTOTUNE_RELAY_CYCLES && w[1].recorded >= AUTOTUNE_RELAY_CYCLES) break;
+
+        for (int i = 0; i < 2; i++) {
+            RelayWheel *rw = &w[i];
+            double v = rw->dir * wheel_speed(i);
+            double eps = AUTOTUNE_HYSTERESIS * rw->setpoint;
+
+            if (v < rw->v_min) rw->v_min = v;
+            if (v > rw->v_max) rw->v_max = v;
+
+            if (rw->relay_high && v > rw->setpoint + eps) {
+                rw->relay_high = 0;
+            } else if (!rw->relay_high && v < rw->setpoint - eps) {
+                rw->relay_high = 1;
+
+                // A low -> high switch closes one full cycle
+                if (rw->last_switch > 0) {
+                    rw->cycles++;
+                    if (rw->cycles > AUTOTUNE_SKIP_CYCLES && rw->recorded < AUTOTUNE_RELAY_CYCLES) {
+                        rw->amp_sum += (rw->v_max - rw->v_min) / 2.0;
+                        rw->period_sum += now - rw->last_switch;
+                        rw->recorded++;
+                    }
+                }
+                rw->last_switch = now;
+                rw->v_min = v;
+                rw->v_max = v;
+            }
+
+            wheel_output(i, rw->dir * (rw->relay_high ? tune_max_pwm : tune_min_pwm));
+        }
+        sleep_us(5000);
+    }
+    return autotune_abort_flag ? -1 : 0;
+}
+
+static void* autotune_thread(void* arg) {
+    (void)arg;
+    RelayWheel w[2] = {{0}, {0}};
+    w[0].dir = 1;
+    w[1].dir = (tune_mode == AUTOTUNE_FLOOR) ? -1 : 1;
+
+    int bias_pwm = (tune_min_pwm + tune_max_pwm) / 2;
+    double relay_d = (tune_max_pwm - tune_min_pwm) / 2.0;
+    int saved = 0;
+
+    printf("AUTOTUNE %s: min=%d%% max=%d%% bias=%d%%\n",
+           tune_mode == AUTOTUNE_FLOOR ? "floor" : "lifted", tune_min_pwm, tune_max_pwm, bias_pwm);
+    fflush(stdout);
+
+    double max_speed[2], setpoint[2];
+    if (run_fixed_phase(w, tune_max_pwm, AUTOTUNE_MAX_SEC, max_speed) < 0) goto done;
+    if (run_fixed_phase(w, bias_pwm, AUTOTUNE_BIAS_SEC, setpoint) < 0) goto done;
+
+    for (int i = 0; i < 2; i++) {
+        w[i].max_speed = max_speed[i];
+        w[i].setpoint = setpoint[i];
+        w[i].relay_high = 1;
+        w[i].v_min = setpoint[i];
+        w[i].v_max = setpoint[i];
+    }
+
+    if (run_relay_phase(w) < 0) goto done;
+
+    for (int i = 0; i < 2; i++) {
+        RelayWheel *rw = &w[i];
+        if (rw->setpoint < 100.0) {
+            printf("ERROR autotune %s: wheel did not move at %d%% (%.0f counts/sec)\n",
+                   wheel_names[i], bias_pwm, rw->setpoint);
+            continue;
+        }
+        if (rw->recorded == 0) {
+            printf("ERROR autotune %s: no relay oscillation detected\n", wheel_names[i]);
+            continue;
+        }
+
+        // Describing function of a relay with hysteresis: Ku = 4d / (pi * sqrt(a^2 - eps^2))
+        double a = rw->amp_sum / rw->recorded;
+        double eps = AUTOTUNE_HYSTERESIS * rw->setpoint;
+        double a_eff = (a > eps) ? sqrt(a * a - eps * eps) : a;
+        double ku = 4.0 * relay_d / (M_PI * a_eff);
+        double pu = rw->period_sum / rw->recorded;
+
+        // Tyreus-Luyben PI: less overshoot than Ziegler-Nichols.
+        // The control thread reads the wheel params under the motor lock
+        WheelParams *wp = &motor_params.wheel[i];
+        pthread_mutex_lock(&motors[i].lock);
+        wp->ku = ku;
+        wp->pu = pu;
+        wp->vel_kp = ku / 3.2;
+        wp->vel_ki = wp->vel_kp / (2.2 * pu);
+        wp->max_speed = rw->max_speed;
+        pthread_mutex_unlock(&motors[i].lock);
+        saved++;
+
+        printf("AUTOTUNE %s: Ku=%.5f Pu=%.3fs kp=%.5f ki=%.5f max_speed=%.0f (%d cycles)\n",
+               wheel_names[i], ku, pu, wp->vel_kp, wp->vel_ki, wp->max_speed, rw->recorded);
+    }
+
+done:
+    for (int i = 0; i < 2; i++) wheel_output(i, 0);
+
+    if (autotune_abort_flag) {
+        printf("ERROR autotune aborted\n");
+    } else if (saved > 0 && params_save(&motor_params, PARAMS_FILE) == 0) {
+        printf("OK autotune saved %d wheel(s) to %s\n", saved, PARAMS_FILE);
+    } else {
+        printf("ERROR autotune failed, parameters unchanged\n");
+    }
+    fflush(stdout);
+
+    autotune_running = 0;
+    return NULL;
+}
+
+// Wait for the autotune thread to exit, so it can no longer write to the motors
+static void autotune_join(void) {
+    if (!autotune_joinable) return;
+    pthread_join(autotune_tid, NULL);
+    autotune_joinable = 0;
+}
+
+int autotune_start(AutotuneMode mode, int min_pwm, int max_pwm) {
+    if (autotune_running) return -1;
+    autotune_join(); // Reap the previous (finished) run
+
+    tune_mode = mode;
+    tune_min_pwm = min_pwm;
+    tune_max_pwm = max_pwm;
+    autotune_abort_flag = 0;
+    autotune_running = 1;
+
+    if (pthread_create(&autotune_tid, NULL, autotune_thread, NULL) != 0) {
+        autotune_running = 0;
+        return -1;
+    }
+    autotune_joinable = 1;
+    return 0;
+}
+
+void autotune_abort(void) {
+    if (autotune_running) autotune_abort_flag = 1;
+    // Synchronous: the thread's last write (wheels to 0) lands before the caller takes over
+    autotune_join();
+}
+
+int autotune_active(void) {
+    return autotune_running;
+}
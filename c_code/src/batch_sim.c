@@ -0,0 +1,766 @@
+// Monte Carlo batch simulator: many simulated robots drive a course with the
+// real controller logic (navigation.c, control.c, esc.c) against the SoA plant in sim.c.
+// Build: make sim    Run: ./asgc_batch_sim --robots 4096 --route yellow,blue,green,red
+// Latency characterization: ./asgc_batch_sim --sweep sensor-delay=0,10,20,40 --csv curve.csv
+// Navigation queue legs: python3 ../tools/plan_route.py yellow blue | ./asgc_batch_sim --legs -
+
+#include "../include/common.h"
+#include "../include/motor.h"
+#include "../include/params.h"
+#include "../include/control.h"
+#include "../include/esc.h"
+#include "../include/landmark.h"
+#include "../include/navigation.h"
+#include "../include/sim.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <strings.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <math.h>
+
+#define MAX_ROUTE 32
+#define MAX_SWEEP 32
+#define SETTLE_TIME 1.0    // Keep simulating after the last robot finishes, to catch its final coast
+
+typedef struct {
+    double x[MAX_ROUTE];
+    double y[MAX_ROUTE];
+    const char *name[MAX_ROUTE];
+    int arrival[MAX_ROUTE];   // ArrivalMode per point
+    double speed[MAX_ROUTE];  // Leg drive speed cap below --speed (the slider), 0 = none
+    double accel[MAX_ROUTE];  // Leg PWM ramp (percent/sec), 0 = none
+    int open_leg[MAX_ROUTE];  // Leg of a command that ends short of it, not a target of its own
+    int count;
+} Route;
+
+// Controller state of one robot, as held by main.c on the real robot
+typedef struct {
+    NavigationController nav;
+    ContactDetector contact;
+    EncoderState enc[2];
+    OdometryState odom;
+    EscShaper esc[2];
+    int pwm[2];
+    int leg;               // Route index being driven to
+    int targets;           // Route targets reached (open legs don't count)
+    int finished;
+    double finish_time;
+    double error_sum;      // True distance to target at each target ARRIVED
+    double final_error;
+    int moves;             // Turn and drive moves (correction cycles) over the course
+    int fixes;             // Bucket contacts applied as position fixes
+    int rejected;          // Bucket contacts rejected by the landmark gate
+    int stalled;           // GOTOs stopped by the move stall timeout (NAVERROR stall)
+    int last_turn;         // Direction of the previous move if it was a turn (-1, 1), else 0
+    int turn_reversals;    // Turns straight after a turn the other way (GOTO oscillation)
+    int move_open;         // A move has started and its overshoot is being tracked
+    int32_t overshoot;     // True travel past the current move's target (counts, either wheel)
+    int overshoots;        // Moves that went more than STOP_THRESHOLD past their target
+    double overshoot_sum;
+    int moves_closed;
+} SimRobot;
+
+typedef struct {
+    int finished;
+    double course_time;
+    double final_error;
+    double leg_error;          // Mean true arrival error over legs
+    double moves_per_leg;
+    double reversals_per_leg;
+    int fixes;
+    int rejected;
+    int stalled;
+    int moves;                 // Moves with a tracked overshoot
+    int overshoots;
+    double overshoot_sum;
+} RobotResult;
+
+// One batch run: everything but the per-thread split
+typedef struct {
+    int robots;
+    int threads;
+    uint32_t seed;
+    const Route *route;
+    const MotorParams *params;
+    MotorParams model;     // The controller's motor model: params, or with the latency fitted in
+    int fit_latency;
+    SimNoise noise;
+    SimLatency latency;
+    double speed;
+    int min_pwm;
+    int max_pwm;
+    double time_limit;
+} SimConfig;
+
+typedef struct {
+    const SimConfig *config;
+    int robots;
+    uint32_t seed;
+    RobotResult *results;
+    int failed;
+    int threaded;          // Runs on its own thread (to be joined)
+} SimJob;
+
+// Aggregate metrics of a run, one point on a latency curve
+typedef struct {
+    double completed;          // Fraction of robots that finished the route
+    double course_mean, course_p95;   // Time and error stats are over finished robots
+    double final_mean, final_p95;
+    double arrival_mean;
+    double moves_per_leg;
+    double reversals_per_leg;
+    double overshoot_rate;     // Fraction of moves ending more than STOP_THRESHOLD past target
+    double overshoot_mean;     // Mean peak travel past target per move (counts)
+} BatchSummary;
+
+// Peak true travel past the target the controller aimed for (move start + target).
+// Measured on the undelayed encoder, through the coast after the move ends.
+static void track_overshoot(SimRobot *r, const SimPlant *sim, int lane) {
+    if (!r->move_open) return;
+    for (int w = 0; w < 2; w++) {
+        const EncoderState *enc = &r->enc[w];
+        int32_t aim = enc->move_start_counts + enc->target_counts;
+        int32_t past = sim->total[w][lane] - aim;
+        if (enc->target_counts < 0) past = -past;
+        if (past > r->overshoot) r->overshoot = past;
+    }
+}
+
+static void close_move(SimRobot *r) {
+    if (!r->move_open) return;
+    r->moves_closed++;
+    r->overshoot_sum += r->overshoot;
+    if (r->overshoot > STOP_THRESHOLD) r->overshoots++;
+    r->overshoot = 0;
+    r->move_open = 0;
+}
+
+// Distance from where the robot should have stopped: touching the bucket for a
+// landmark target (its center can't get closer than the contact offset), else the point
+static double arrival_error(const SimPlant *sim, int lane, double x, double y) {
+    double error = hypot(sim->x[lane] - x, sim->y[lane] - y);
+    if (landmark_at(x, y) >= 0) error = fabs(error - LANDMARK_CONTACT_OFFSET_FT);
+    return error;
+}
+
+// coordinated_control_thread for one robot: the same nav_step(), plus metrics
+static void robot_control(SimRobot *r, SimPlant *sim, int lane, const SimConfig *cfg, double now) {
+    const Route *route = cfg->route;
+
+    // A dropped read leaves the previous sample in place, like a failed sensor read
+    sim_read_sensors(sim, lane, r->enc, &r->odom);
+
+    if (r->nav.state == NAV_IDLE) {
+        // Python sends the next queued GOTO as soon as the controller reports IDLE
+        r->pwm[0] = r->pwm[1] = 0;
+        if (!r->finished && r->leg < route->count) {
+            nav_start_goto(&r->nav, route->x[r->leg], route->y[r->leg], route->arrival[r->leg],
+                           route->speed[r->leg], route->accel[r->leg]);
+            r->last_turn = 0;
+        }
+    } else {
+        NavStep step;
+        nav_step(&r->nav, &r->contact, r->enc, &r->odom, &cfg->model, cfg->min_pwm, cfg->max_pwm, now, &step);
+        r->pwm[0] = step.pwm[0];
+        r->pwm[1] = step.pwm[1];
+
+        if (step.events & NAV_EVENT_TURN) {
+            int dir = step.heading_diff > 0 ? 1 : -1;
+            if (r->last_turn == -dir) r->turn_reversals++;
+            r->last_turn = dir;
+        }
+        if (step.events & NAV_EVENT_DRIVE) r->last_turn = 0;
+        if (step.events & (NAV_EVENT_TURN | NAV_EVENT_DRIVE)) {
+            close_move(r);
+            r->moves++;
+            r->move_open = 1;
+        }
+        if (step.events & NAV_EVENT_LANDMARK) {
+            // The controller corrected its copy of the pose; the plant's odometry is the source
+            sim_correct_odometry(sim, lane, step.dx, step.dy);
+            r->fixes++;
+        }
+        if (step.events & NAV_EVENT_REJECTED) r->rejected++;
+        // NAVERROR clears the queue: the robot never finishes
+        if (step.events & (NAV_EVENT_WRONG_WAY | NAV_EVENT_STALLED)) {
+            r->leg = route->count;
+            r->stalled += !!(step.events & NAV_EVENT_STALLED);
+        }
+        if (step.events & NAV_EVENT_ARRIVED) {
+            double error = arrival_error(sim, lane, r->nav.target_x, r->nav.target_y);
+            if (!route->open_leg[r->leg]) {
+                r->error_sum += error;
+                r->targets++;
+            }
+            r->final_error = error;
+            if (++r->leg == route->count) {
+                r->finished = 1;
+                r->finish_time = now;
+            }
+        }
+    }
+
+    int pulse[2];
+    for (int w = 0; w < 2; w++) {
+        pulse[w] = esc_shape(&r->esc[w], &cfg->model.esc, pulse_from_percent(r->pwm[w]),
+                             r->enc[w].velocity, now);
+    }
+    sim_write_command(sim, lane, (float)(pulse[0] - NEUTRAL_NS), (float)(pulse[1] - NEUTRAL_NS));
+}
+
+static void *sim_worker(void *arg) {
+    SimJob *job = (SimJob *)arg;
+    const SimConfig *cfg = job->config;
+    SimPlant sim;
+    job->failed = 1;
+    if (sim_init(&sim, job->robots, cfg->params, &cfg->noise, job->seed) < 0) return NULL;
+    if (sim_set_latency(&sim, &cfg->latency) < 0) {
+        sim_free(&sim);
+        return NULL;
+    }
+    sim_reset_pose(&sim, START_X, START_Y, START_HEADING);
+
+    SimRobot *robots = calloc(job->robots, sizeof(SimRobot));
+    if (!robots) {
+        sim_free(&sim);
+        return NULL;
+    }
+    for (int i = 0; i < job->robots; i++) {
+        robots[i].nav.state = NAV_IDLE;
+        robots[i].nav.speed_multiplier = cfg->speed;
+        robots[i].nav.target_landmark = -1;
+        contact_reset(&robots[i].contact);
+        for (int w = 0; w < 2; w++) {
+            esc_reset(&robots[i].esc[w]);
+            velocity_loop_reset(&robots[i].enc[w]);
+        }
+        sim_read_sensors(&sim, i, robots[i].enc, &robots[i].odom);
+        robots[i].odom.pos_var = ODOM_INITIAL_VAR; // Hand placement, as at startup
+    }
+
+    int remaining = job->robots;
+    double settle_end = cfg->time_limit;
+    while (sim.time < settle_end) {
+        sim_step(&sim);
+        if (sim.step % SIM_CONTROL_DIV != 0) continue;
+
+        remaining = 0;
+        for (int i = 0; i < job->robots; i++) {
+            track_overshoot(&robots[i], &sim, i);
+            if (robots[i].finished) {
+                sim_write_command(&sim, i, 0, 0);
+                continue;
+            }
+            robot_control(&robots[i], &sim, i, cfg, sim.time);
+            remaining += !robots[i].finished;
+        }
+        if (remaining == 0 && settle_end == cfg->time_limit) settle_end = sim.time + SETTLE_TIME;
+    }
+
+    for (int i = 0; i < job->robots; i++) {
+        SimRobot *r = &robots[i];
+        RobotResult *out = &job->results[i];
+        close_move(r);
+        int legs = r->targets ? r->targets : 1;
+        out->finished = r->finished;
+        out->course_time = r->finished ? r->finish_time : cfg->time_limit;
+        out->final_error = r->final_error;
+        out->leg_error = r->targets ? r->error_sum / r->targets : 0;
+        out->moves_per_leg = (double)r->moves / legs;
+        out->reversals_per_leg = (double)r->turn_reversals / legs;
+        out->fixes = r->fixes;
+        out->rejected = r->rejected;
+        out->stalled = r->stalled;
+        out->moves = r->moves_closed;
+        out->overshoots = r->overshoots;
+        out->overshoot_sum = r->overshoot_sum;
+    }
+
+    free(robots);
+    sim_free(&sim);
+    job->failed = 0;
+    return NULL;
+}
+
+static int compare_double(const void *a, const void *b) {
+    double da = *(const double *)a, db = *(const double *)b;
+    return (da > db) - (da < db);
+}
+
+typedef struct {
+    double mean, p50, p95, max;
+} Stats;
+
+// Sorts values in place
+static Stats compute_stats(double *values, int count) {
+    Stats st = {0, 0, 0, 0};
+    if (count == 0) return st;
+    qsort(values, count, sizeof(double), compare_double);
+    double sum = 0;
+    for (int i = 0; i < count; i++) sum += values[i];
+    st.mean = sum / count;
+    st.p50 = values[count / 2];
+    st.p95 = values[(int)(count * 0.95)];
+    st.max = values[count - 1];
+    return st;
+}
+
+static void print_stats(const char *label, double *values, int count) {
+    if (count == 0) {
+        printf("  %-22s (no samples)\n", label);
+        return;
+    }
+    Stats st = compute_stats(values, count);
+    printf("  %-22s mean %8.3f  p50 %8.3f  p95 %8.3f  max %8.3f\n", label, st.mean, st.p50, st.p95, st.max);
+}
+
+// Per-robot metric as a double, for the stats helpers
+typedef double (*ResultField)(const RobotResult *r);
+static double field_course_time(const RobotResult *r) { return r->course_time; }
+static double field_final_error(const RobotResult *r) { return r->final_error; }
+static double field_leg_error(const RobotResult *r) { return r->leg_error; }
+static double field_moves(const RobotResult *r) { return r->moves_per_leg; }
+static double field_reversals(const RobotResult *r) { return r->reversals_per_leg; }
+
+// Collect a metric over robots (only finished ones if finished_only). Returns the count.
+static int collect(const RobotResult *results, int robots, ResultField field, int finished_only, double *out) {
+    int count = 0;
+    for (int i = 0; i < robots; i++) {
+        if (finished_only && !results[i].finished) continue;
+        out[count++] = field(&results[i]);
+    }
+    return count;
+}
+
+static void summarize(const RobotResult *results, int robots, double *scratch, BatchSummary *sum) {
+    int done = collect(results, robots, field_course_time, 1, scratch);
+    Stats course = compute_stats(scratch, done);
+    collect(results, robots, field_final_error, 1, scratch);
+    Stats final = compute_stats(scratch, done);
+    collect(results, robots, field_leg_error, 1, scratch);
+    Stats arrival = compute_stats(scratch, done);
+    collect(results, robots, field_moves, 0, scratch);
+    Stats moves = compute_stats(scratch, robots);
+    collect(results, robots, field_reversals, 0, scratch);
+    Stats reversals = compute_stats(scratch, robots);
+
+    long move_count = 0, overshoots = 0;
+    double overshoot_sum = 0;
+    for (int i = 0; i < robots; i++) {
+        move_count += results[i].moves;
+        overshoots += results[i].overshoots;
+        overshoot_sum += results[i].overshoot_sum;
+    }
+
+    sum->completed = (double)done / robots;
+    sum->course_mean = course.mean;
+    sum->course_p95 = course.p95;
+    sum->final_mean = final.mean;
+    sum->final_p95 = final.p95;
+    sum->arrival_mean = arrival.mean;
+    sum->moves_per_leg = moves.mean;
+    sum->reversals_per_leg = reversals.mean;
+    sum->overshoot_rate = move_count ? (double)overshoots / move_count : 0;
+    sum->overshoot_mean = move_count ? overshoot_sum / move_count : 0;
+}
+
+// Run all robots of a configuration across cfg->threads. Returns 0 on success.
+static int run_batch(const SimConfig *cfg, RobotResult *results) {
+    SimJob *jobs = calloc(cfg->threads, sizeof(SimJob));
+    pthread_t *tids = calloc(cfg->threads, sizeof(pthread_t));
+    if (!jobs || !tids) {
+        free(jobs);
+        free(tids);
+        return -1;
+    }
+
+    // Each thread owns a contiguous block of robots with its own plant and seed
+    int offset = 0;
+    for (int t = 0; t < cfg->threads; t++) {
+        SimJob *job = &jobs[t];
+        job->config = cfg;
+        job->robots = cfg->robots / cfg->threads + (t < cfg->robots % cfg->threads);
+        job->seed = cfg->seed * 7919u + (uint32_t)t * 104729u;
+        job->results = results + offset;
+        offset += job->robots;
+        job->threaded = pthread_create(&tids[t], NULL, sim_worker, job) == 0;
+        if (!job->threaded) {
+            // Results only depend on the job seed, so running the block here gives the same batch
+            fprintf(stderr, "Warning: could not start simulation thread %d, running its robots inline\n", t);
+            sim_worker(job);
+        }
+    }
+
+    int failed = 0;
+    for (int t = 0; t < cfg->threads; t++) {
+        if (jobs[t].threaded) pthread_join(tids[t], NULL);
+        failed |= jobs[t].failed;
+    }
+    free(jobs);
+    free(tids);
+    return failed ? -1 : 0;
+}
+
+// Latency settings, usable as --<name> VALUE and --sweep <name>=v1,v2,...
+typedef struct {
+    const char *name;
+    size_t offset;      // Field in SimLatency
+    double scale;       // Command line unit to seconds / probability
+    const char *unit;
+} LatencyParam;
+
+static const LatencyParam latency_params[] = {
+    {"sensor-delay",    offsetof(SimLatency, sensor_delay),    0.001, "ms"},
+    {"sensor-jitter",   offsetof(SimLatency, sensor_jitter),   0.001, "ms"},
+    {"sensor-drop",     offsetof(SimLatency, sensor_drop),     0.01,  "%"},
+    {"actuator-delay",  offsetof(SimLatency, actuator_delay),  0.001, "ms"},
+    {"actuator-jitter", offsetof(SimLatency, actuator_jitter), 0.001, "ms"},
+    {"actuator-drop",   offsetof(SimLatency, actuator_drop),   0.01,  "%"},
+};
+#define LATENCY_PARAM_COUNT (int)(sizeof(latency_params) / sizeof(latency_params[0]))
+
+static const LatencyParam *latency_param_find(const char *name, size_t len) {
+    for (int i = 0; i < LATENCY_PARAM_COUNT; i++) {
+        if (strlen(latency_params[i].name) == len && strncmp(latency_params[i].name, name, len) == 0) {
+            return &latency_params[i];
+        }
+    }
+    return NULL;
+}
+
+static void latency_param_set(SimLatency *lat, const LatencyParam *param, double value) {
+    *(float *)((char *)lat + param->offset) = (float)(value * param->scale);
+}
+
+// "name=v1,v2,..." -> param and values. Returns the value count, -1 on error.
+static int parse_sweep(const char *spec, const LatencyParam **param, double *values) {
+    const char *eq = strchr(spec, '=');
+    if (!eq || !(*param = latency_param_find(spec, eq - spec))) return -1;
+
+    char buf[256];
+    snprintf(buf, sizeof(buf), "%s", eq + 1);
+    int count = 0;
+    for (char *tok = strtok(buf, ","); tok; tok = strtok(NULL, ",")) {
+        if (count >= MAX_SWEEP) return -1;
+        values[count++] = atof(tok);
+    }
+    return count;
+}
+
+// motor_sysid.py times the step response from logged commands to logged encoder
+// samples, so on a robot with this latency its dead time includes the fixed delays
+static void fit_controller_model(SimConfig *cfg) {
+    cfg->model = *cfg->params;
+    if (!cfg->fit_latency) return;
+    for (int w = 0; w < 2; w++) {
+        cfg->model.wheel[w].dead_time += cfg->latency.sensor_delay + cfg->latency.actuator_delay;
+    }
+}
+
+static void print_latency(const SimLatency *lat) {
+    printf("Injected latency: sensor %.0f ms + %.0f ms jitter, %.1f%% dropped; "
+           "actuator %.0f ms + %.0f ms jitter, %.1f%% dropped\n",
+           lat->sensor_delay * 1000, lat->sensor_jitter * 1000, lat->sensor_drop * 100,
+           lat->actuator_delay * 1000, lat->actuator_jitter * 1000, lat->actuator_drop * 100);
+}
+
+// Legs as the navigation queue sends them, from tools/plan_route.py: a "# <target>"
+// line per queued command, then one goto line per leg. All legs but the last of a
+// command are open legs. Returns 0 on success.
+static int read_legs(const char *path, Route *route) {
+    static char names[MAX_ROUTE][32];
+    FILE *f = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "ERROR: Cannot read legs from %s\n", path);
+        return -1;
+    }
+
+    char line[256];
+    int command = -1, block[MAX_ROUTE], failed = 0;
+    route->count = 0;
+    while (!failed && fgets(line, sizeof(line), f)) {
+        char *text = line + strspn(line, " \t");
+        text[strcspn(text, "\r\n")] = '\0';
+        if (text[0] == '#') {
+            if (++command >= MAX_ROUTE) failed = 1;
+            else sscanf(text + 1, "%31s", names[command]);
+            continue;
+        }
+        if (text[0] == '\0') continue;
+
+        double x, y, speed = 0.0, accel = 0.0;
+        char mode[16] = "precise";
+        int fields = sscanf(text, "goto %lf %lf %15s %lf %lf", &x, &y, mode, &speed, &accel);
+        int arrival = arrival_find(mode);
+        if (fields < 2 || arrival < 0 || command < 0 || route->count >= MAX_ROUTE) {
+            fprintf(stderr, "ERROR: Invalid leg '%s'\n", text);
+            failed = 1;
+            continue;
+        }
+        int i = route->count++;
+        route->x[i] = x;
+        route->y[i] = y;
+        route->name[i] = names[command];
+        route->arrival[i] = arrival;
+        route->speed[i] = speed;
+        route->accel[i] = accel;
+        block[i] = command;
+    }
+    if (f != stdin) fclose(f);
+    if (failed || route->count == 0) return -1;
+
+    for (int i = 0; i < route->count; i++) {
+        route->open_leg[i] = i + 1 < route->count && block[i + 1] == block[i];
+    }
+    return 0;
+}
+
+static int parse_route(const char *spec, Route *route) {
+    char buf[256];
+    snprintf(buf, sizeof(buf), "%s", spec);
+    route->count = 0;
+    for (char *tok = strtok(buf, ","); tok; tok = strtok(NULL, ",")) {
+        if (route->count >= MAX_ROUTE) return -1;
+
+        // Optional ":precise" / ":pass", then ":speed" and ":accel" (-1 = not given)
+        int arrival = -1;
+        double speed = -1, accel = -1;
+        char *mode = strchr(tok, ':');
+        if (mode) {
+            *mode++ = '\0';
+            char *limits = strchr(mode, ':');
+            if (limits) {
+                *limits++ = '\0';
+                if (sscanf(limits, "%lf:%lf", &speed, &accel) < 1 || speed < 0 || speed > 1) {
+                    fprintf(stderr, "ERROR: Invalid leg limits '%s' (speed 0-1, accel %%/s)\n", limits);
+                    return -1;
+                }
+            }
+            if ((arrival = arrival_find(mode)) < 0) {
+                fprintf(stderr, "ERROR: Unknown arrival mode '%s'\n", mode);
+                return -1;
+            }
+        }
+        route->arrival[route->count] = arrival;
+        route->speed[route->count] = speed;
+        route->accel[route->count] = accel;
+        route->open_leg[route->count] = 0;
+
+        int id = landmark_find(tok);
+        if (id >= 0) {
+            route->x[route->count] = landmarks[id].x;
+            route->y[route->count] = landmarks[id].y;
+            route->name[route->count] = landmarks[id].name;
+        } else if (strcasecmp(tok, "center") == 0) {
+            route->x[route->count] = 15.0;
+            route->y[route->count] = 15.0;
+            route->name[route->count] = "center";
+        } else {
+            fprintf(stderr, "ERROR: Unknown route point '%s'\n", tok);
+            return -1;
+        }
+        route->count++;
+    }
+
+    // Like the navigation queue: the center is a pass-through waypoint unless it is the last stop
+    for (int i = 0; i < route->count; i++) {
+        if (route->speed[i] < 0) route->speed[i] = 0;
+        if (route->accel[i] < 0) route->accel[i] = 0;
+        if (route->arrival[i] >= 0) continue;
+        int waypoint = strcmp(route->name[i], "center") == 0 && i < route->count - 1;
+        route->arrival[i] = waypoint ? ARRIVE_PASS : ARRIVE_PRECISE;
+    }
+    return route->count > 0 ? 0 : -1;
+}
+
+static void usage(const char *prog) {
+    printf("Usage: %s [options]\n", prog);
+    printf("  --robots N        Simulated robots (default 4096)\n");
+    printf("  --threads N       Worker threads (default: all CPUs)\n");
+    printf("  --seed N          Noise seed (default 1)\n");
+    printf("  --route a,b,...   Bucket names or center, each optionally :precise|pass[:speed[:accel]]\n");
+    printf("                    (default yellow,blue,green,red)\n");
+    printf("  --legs FILE       Legs as the navigation queue sends them (tools/plan_route.py, - = stdin)\n");
+    printf("  --speed S         Speed multiplier 0-1 (default 0.3)\n");
+    printf("  --pwm MIN MAX     PWM limits (default 45 80)\n");
+    printf("  --time-limit S    Simulated seconds before a robot counts as stuck (default 300)\n");
+    printf("  --params FILE     Motor parameter file (default %s)\n", PARAMS_FILE);
+    printf("  --no-noise        Identical robots, noiseless sensors\n");
+    printf("Latency injection (between the plant and the controller):\n");
+    for (int i = 0; i < LATENCY_PARAM_COUNT; i++) {
+        printf("  --%-16s Extra %s (%s, default 0)\n", latency_params[i].name,
+               strchr(latency_params[i].name, '-') + 1, latency_params[i].unit);
+    }
+    printf("  --fit-latency     Controller dead time includes the fixed delays, as motor_sysid.py fits it\n");
+    printf("  --sweep NAME=V,.. Run once per value of a latency setting and print the curve\n");
+    printf("  --csv FILE        Write the sweep curve as CSV (for tools/latency_curves.py)\n");
+}
+
+int main(int argc, char *argv[]) {
+    int threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    const char *route_spec = "yellow,blue,green,red";
+    const char *legs_path = NULL;
+    const char *params_path = PARAMS_FILE;
+    const char *sweep_spec = NULL;
+    const char *csv_path = NULL;
+    SimConfig cfg = {
+        .robots = 4096, .seed = 1, .speed = 0.3, .min_pwm = 45, .max_pwm = 80, .time_limit = 300.0,
+        .noise = {
+            .gain = 0.05f, .deadband = 0.10f, .tau = 0.10f, .wheel_diameter = 0.01f,
+            .gyro_bias = 0.05f, .gyro_noise = 0.15f, .encoder_noise = 0.5f,
+        },
+    };
+
+    for (int i = 1; i < argc; i++) {
+        const LatencyParam *lp = strncmp(argv[i], "--", 2) == 0 ? latency_param_find(argv[i] + 2, strlen(argv[i] + 2)) : NULL;
+        if (lp && i + 1 < argc) latency_param_set(&cfg.latency, lp, atof(argv[++i]));
+        else if (strcmp(argv[i], "--robots") == 0 && i + 1 < argc) cfg.robots = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) cfg.seed = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--route") == 0 && i + 1 < argc) route_spec = argv[++i];
+        else if (strcmp(argv[i], "--legs") == 0 && i + 1 < argc) legs_path = argv[++i];
+        else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) cfg.speed = atof(argv[++i]);
+        else if (strcmp(argv[i], "--pwm") == 0 && i + 2 < argc) {
+            cfg.min_pwm = atoi(argv[++i]);
+            cfg.max_pwm = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--time-limit") == 0 && i + 1 < argc) cfg.time_limit = atof(argv[++i]);
+        else if (strcmp(argv[i], "--params") == 0 && i + 1 < argc) params_path = argv[++i];
+        else if (strcmp(argv[i], "--no-noise") == 0) memset(&cfg.noise, 0, sizeof(cfg.noise));
+        else if (strcmp(argv[i], "--fit-latency") == 0) cfg.fit_latency = 1;
+        else if (strcmp(argv[i], "--sweep") == 0 && i + 1 < argc) sweep_spec = argv[++i];
+        else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) csv_path = argv[++i];
+        else {
+            usage(argv[0]);
+            return strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+    if (cfg.robots < 1) cfg.robots = 1;
+    if (threads < 1) threads = 1;
+    cfg.threads = threads > cfg.robots ? cfg.robots : threads;
+
+    Route route;
+    if (legs_path) {
+        if (read_legs(legs_path, &route) < 0) {
+            fprintf(stderr, "ERROR: Invalid legs file '%s'\n", legs_path);
+            return 1;
+        }
+        route_spec = legs_path;
+    } else if (parse_route(route_spec, &route) < 0) {
+        fprintf(stderr, "ERROR: Invalid route '%s'\n", route_spec);
+        return 1;
+    }
+    cfg.route = &route;
+
+    const LatencyParam *sweep_param = NULL;
+    double sweep_values[MAX_SWEEP];
+    int sweep_count = 0;
+    if (sweep_spec && (sweep_count = parse_sweep(sweep_spec, &sweep_param, sweep_values)) <= 0) {
+        fprintf(stderr, "ERROR: Invalid sweep '%s' (expected e.g. sensor-delay=0,10,20)\n", sweep_spec);
+        return 1;
+    }
+
+    MotorParams params;
+    params_set_defaults(&params);
+    if (params_load(&params, params_path) < 0) {
+        printf("No parameter file at %s, using default motor model\n", params_path);
+    }
+    cfg.params = &params;
+
+    RobotResult *results = malloc(sizeof(RobotResult) * cfg.robots);
+    double *scratch = malloc(sizeof(double) * cfg.robots);
+    if (!results || !scratch) {
+        fprintf(stderr, "ERROR: Out of memory\n");
+        return 1;
+    }
+
+    printf("Simulating %d robots on %d threads: route %s, speed %.2f, PWM %d-%d\n",
+           cfg.robots, cfg.threads, route_spec, cfg.speed, cfg.min_pwm, cfg.max_pwm);
+
+    if (!sweep_param) {
+        print_latency(&cfg.latency);
+        fit_controller_model(&cfg);
+        if (cfg.fit_latency) printf("Controller dead time %.0f/%.0f ms (fitted with the fixed delays)\n",
+                                    cfg.model.wheel[0].dead_time * 1000, cfg.model.wheel[1].dead_time * 1000);
+        double wall_start = get_time_sec();
+        if (run_batch(&cfg, results) < 0) {
+            fprintf(stderr, "ERROR: Simulation failed\n");
+            return 1;
+        }
+        double wall = get_time_sec() - wall_start;
+
+        double max_sim_time = 0;
+        for (int i = 0; i < cfg.robots; i++) {
+            if (results[i].course_time > max_sim_time) max_sim_time = results[i].course_time;
+        }
+        BatchSummary sum;
+        summarize(results, cfg.robots, scratch, &sum);
+
+        printf("Finished %d/%d robots (%.1f s wall, %.0f simulated robot-seconds per second)\n",
+               (int)lround(sum.completed * cfg.robots), cfg.robots, wall, cfg.robots * max_sim_time / wall);
+        print_stats("Course time (s)", scratch, collect(results, cfg.robots, field_course_time, 1, scratch));
+        print_stats("Final error (ft)", scratch, collect(results, cfg.robots, field_final_error, 1, scratch));
+        print_stats("Mean arrival err (ft)", scratch, collect(results, cfg.robots, field_leg_error, 1, scratch));
+        print_stats("Moves per leg", scratch, collect(results, cfg.robots, field_moves, 0, scratch));
+        print_stats("Turn reversals/leg", scratch, collect(results, cfg.robots, field_reversals, 0, scratch));
+        printf("  %-22s %.1f%% of moves past STOP_THRESHOLD (%d counts), mean peak %.0f counts\n",
+               "Stop overshoot", sum.overshoot_rate * 100, STOP_THRESHOLD, sum.overshoot_mean);
+        long fixes = 0, rejected = 0, stalled = 0;
+        for (int i = 0; i < cfg.robots; i++) {
+            fixes += results[i].fixes;
+            rejected += results[i].rejected;
+            stalled += results[i].stalled;
+        }
+        printf("  %-22s %.2f position fixes and %.2f rejected contacts per robot\n",
+               "Bucket contacts", (double)fixes / cfg.robots, (double)rejected / cfg.robots);
+        printf("  %-22s %ld robots stopped by the move stall timeout\n", "Stalled", stalled);
+    } else {
+        // Latency curve: one batch per value, same robots and noise each time
+        FILE *csv = NULL;
+        if (csv_path && !(csv = fopen(csv_path, "w"))) {
+            fprintf(stderr, "ERROR: Cannot write %s\n", csv_path);
+            return 1;
+        }
+        const char *columns = "completed_pct,course_mean_s,course_p95_s,final_mean_ft,final_p95_ft,"
+                              "arrival_mean_ft,moves_per_leg,turn_reversals_per_leg,overshoot_pct,overshoot_mean_counts";
+        if (csv) fprintf(csv, "%s_%s,%s\n", sweep_param->name, sweep_param->unit[0] == '%' ? "pct" : sweep_param->unit, columns);
+
+        printf("Sweeping %s (%s)%s\n", sweep_param->name, sweep_param->unit,
+               cfg.fit_latency ? ", controller dead time fitted with the fixed delays" : "");
+        printf("%10s %6s %9s %9s %8s %8s %8s %7s %7s %8s %8s\n", sweep_param->unit, "done%",
+               "course_s", "p95_s", "final_ft", "p95_ft", "arrive", "moves", "revers", "over%", "over_ct");
+        for (int k = 0; k < sweep_count; k++) {
+            latency_param_set(&cfg.latency, sweep_param, sweep_values[k]);
+            fit_controller_model(&cfg);
+            if (run_batch(&cfg, results) < 0) {
+                fprintf(stderr, "ERROR: Simulation failed at %s=%g\n", sweep_param->name, sweep_values[k]);
+                if (csv) fclose(csv);
+                return 1;
+            }
+            BatchSummary sum;
+            summarize(results, cfg.robots, scratch, &sum);
+            printf("%10g %6.1f %9.2f %9.2f %8.3f %8.3f %8.3f %7.2f %7.2f %8.1f %8.0f\n", sweep_values[k],
+                   sum.completed * 100, sum.course_mean, sum.course_p95, sum.final_mean, sum.final_p95,
+                   sum.arrival_mean, sum.moves_per_leg, sum.reversals_per_leg, sum.overshoot_rate * 100,
+                   sum.overshoot_mean);
+            fflush(stdout);
+            if (csv) {
+                fprintf(csv, "%g,%.2f,%.3f,%.3f,%.4f,%.4f,%.4f,%.3f,%.3f,%.2f,%.1f\n", sweep_values[k],
+                        sum.completed * 100, sum.course_mean, sum.course_p95, sum.final_mean, sum.final_p95,
+                        sum.arrival_mean, sum.moves_per_leg, sum.reversals_per_leg, sum.overshoot_rate * 100,
+                        sum.overshoot_mean);
+            }
+        }
+        if (csv) {
+            fclose(csv);
+            printf("Wrote %s\n", csv_path);
+        }
+    }
+
+    free(results);
+    free(scratch);
+    return 0;
+}
@@ -0,0 +1,303 @@
+#include "../include/control.h"
+#include "../include/common.h"
+#include <math.h>
+#include <stdlib.h>
+#include <strings.h>
+
+void update_encoder_velocity(EncoderState *enc, double timestamp) {
+    // First sample: just record the reference point
+    if (enc->velocity_time <= 0) {
+        enc->velocity_time = timestamp;
+        enc->velocity_position = enc->total_counts;
+        return;
+    }
+
+    // Differentiate over a minimum window to limit quantization noise
+    double dt = timestamp - enc->velocity_time;
+    if (dt < VELOCITY_WINDOW_SEC) return;
+
+    double raw_velocity = (enc->total_counts - enc->velocity_position) / dt;
+    enc->velocity += VELOCITY_FILTER_ALPHA * (raw_velocity - enc->velocity);
+
+    enc->velocity_time = timestamp;
+    enc->velocity_position = enc->total_counts;
+}
+
+int velocity_loop_tuned(const WheelParams *wp) {
+    return wp->vel_kp > 0 && wp->max_speed > 0;
+}
+
+void velocity_loop_reset(EncoderState *enc) {
+    enc->vel_integral = 0;
+    enc->vel_last_time = 0;
+    enc->vel_last_target = 0;
+}
+
+int velocity_loop_update(EncoderState *enc, const WheelParams *wp, double target_speed, double now) {
+    double dt = (enc->vel_last_time > 0) ? now - enc->vel_last_time : 0.0;
+    enc->vel_last_time = now;
+
+    // Direction change: old integral pushes the wrong way
+    if (target_speed * enc->vel_last_target < 0) {
+        enc->vel_integral = 0;
+    }
+    enc->vel_last_target = target_speed;
+
+    // Feed-forward from the identified model: deadband plus speed / gain
+    double feedforward = 0.0;
+    if (target_speed != 0 && wp->gain > 0) {
+        double offset_ns = wp->deadband_ns + fabs(target_speed) / wp->gain * 1000.0;
+        feedforward = offset_ns * 100.0 / (FORWARD_MAX_NS - FORWARD_START_NS);
+        if (target_speed < 0) feedforward = -feedforward;
+    }
+
+    double error = target_speed - enc->velocity;
+    enc->vel_integral += wp->vel_ki * error * dt;
+
+    // Anti-windup: keep the integral within what the output can still use
+    double p_term = feedforward + wp->vel_kp * error;
+    if (p_term + enc->vel_integral > 100.0) enc->vel_integral = 100.0 - p_term;
+    if (p_term + enc->vel_integral < -100.0) enc->vel_integral = -100.0 - p_term;
+    if (enc->vel_integral > 100.0) enc->vel_integral = 100.0;
+    if (enc->vel_integral < -100.0) enc->vel_integral = -100.0;
+
+    double output = p_term + enc->vel_integral;
+    if (output > 100.0) output = 100.0;
+    if (output < -100.0) output = -100.0;
+    return (int)lround(output);
+}
+
+int pulse_from_percent(int speed_percent) {
+    if (speed_percent > 100) speed_percent = 100;
+    if (speed_percent < -100) speed_percent = -100;
+
+    if (speed_percent > 0) {
+        // Map 0-100% to FORWARD_START_NS to FORWARD_MAX_NS
+        return FORWARD_START_NS + (speed_percent * (FORWARD_MAX_NS - FORWARD_START_NS)) / 100;
+    } else if (speed_percent < 0) {
+        // Map 0-(-100%) to REVERSE_START_NS to REVERSE_MAX_NS
+        return REVERSE_START_NS - (abs(speed_percent) * (REVERSE_START_NS - REVERSE_MAX_NS)) / 100;
+    }
+    return NEUTRAL_NS;
+}
+
+int32_t calculate_turn_counts(double degrees) {
+    double arc_length = (fabs(degrees) / 360.0) * M_PI * WHEELBASE_INCHES;
+    return (int32_t)(arc_length * COUNTS_PER_INCH);
+}
+
+int32_t turn_left_counts(double heading_diff) {
+    int32_t counts = TURN_LEFT_FORWARD_SIGN * calculate_turn_counts(heading_diff);
+    return heading_diff < 0 ? -counts : counts;
+}
+
+// Signed difference a - b, wrapped to -180..180
+static double heading_delta(double a, double b) {
+    double d = a - b;
+    while (d > 180) d -= 360;
+    while (d < -180) d += 360;
+    return d;
+}
+
+int turn_wrong_way(double start_heading, double target_heading, double heading) {
+    double commanded = heading_delta(target_heading, start_heading);
+    double turned = heading_delta(heading, start_heading);
+    return (commanded > 0 ? -turned : turned) > TURN_WRONG_WAY_DEG;
+}
+
+const ArrivalProfile arrival_profiles[] = {
+    [ARRIVE_PRECISE] = {"precise", 0.5, 5.0, 1},
+    [ARRIVE_PASS] = {"pass", 1.5, 15.0, 0},
+};
+
+int arrival_find(const char *name) {
+    for (int i = 0; i < (int)(sizeof(arrival_profiles) / sizeof(arrival_profiles[0])); i++) {
+        if (strcasecmp(name, arrival_profiles[i].name) == 0) return i;
+    }
+    return -1;
+}
+
+void wheel_move_start(EncoderState *enc, int32_t counts, double now) {
+    enc->move_start_counts = enc->total_counts; // Capture start position
+    enc->target_counts = counts;
+    enc->has_target = 1;
+    enc->move_pwm = 0;
+    enc->move_start_time = now;
+    enc->stall_count = 0;
+    enc->stall_check_time = now;
+    enc->stall_last_position = 0;
+    velocity_loop_reset(enc);
+}
+
+int32_t wheel_move_position(const EncoderState *enc) {
+    // total_counts already includes the raw angle within the current rotation
+    return enc->total_counts - enc->move_start_counts;
+}
+
+int32_t wheel_move_error(const EncoderState *enc) {
+    return enc->target_counts - wheel_move_position(enc);
+}
+
+double wheel_model_speed(const WheelParams *wp, int speed_percent) {
+    if (speed_percent == 0 || wp->gain <= 0) return 0.0;
+    double offset_ns = abs(pulse_from_percent(speed_percent) - NEUTRAL_NS);
+    double speed = wp->gain * (offset_ns - wp->deadband_ns) / 1000.0;
+    if (speed < 0) return 0.0;
+    return speed_percent > 0 ? speed : -speed;
+}
+
+double wheel_stop_distance(const EncoderState *enc, const WheelParams *wp) {
+    double v = enc->velocity;
+    double travel = v * wp->dead_time;
+
+    // Below the speed it is driven to, the wheel is still on its first-order rise
+    double drive = wheel_model_speed(wp, enc->move_pwm);
+    if (wp->tau > 0 && drive * v >= 0 && fabs(drive) > fabs(v)) {
+        double now = drive + (v - drive) * exp(-VELOCITY_LAG_SEC / wp->tau);
+        double decay = exp(-wp->dead_time / wp->tau);
+        travel = drive * wp->dead_time + (now - drive) * wp->tau * (1.0 - decay);
+        v = drive + (now - drive) * decay;
+    }
+
+    double coast = wp->coast_decel > 0 ? v * fabs(v) / (2.0 * wp->coast_decel) : 0.0;
+    return travel + coast;
+}
+
+MoveLimits move_limits(int min_pwm, int pwm_limit, double speed, double accel, int settle) {
+    MoveLimits limits = {(int)(pwm_limit * speed), pwm_limit, min_pwm, accel, settle};
+    if (limits.max_pwm < min_pwm) limits.max_pwm = min_pwm; // Ensure we can move
+    return limits;
+}
+
+int wheel_move_step(EncoderState *enc, const WheelParams *wp, const MoveLimits *limits, double now, int *pwm) {
+    // Calculate relative position and error
+    int32_t current_relative = wheel_move_position(enc);
+    int32_t error = enc->target_counts - current_relative;
+    double coast = wheel_stop_distance(enc, wp);
+    *pwm = 0;
+    enc->move_pwm = 0;
+
+    // Judge the move where the wheel comes to rest: stopped there (settle), or
+    // where the coast will take it (pass-through, the next move starts rolling)
+    double final_error = limits->settle ? error : error - coast;
+    int stopping = !limits->settle || fabs(enc->velocity) < SETTLE_SPEED;
+
+    if (fabs(final_error) < STOP_THRESHOLD && stopping) {
+        // Within stop threshold - we're done
+        enc->has_target = 0;
+        enc->stall_count = 0;
+        return 1;
+    }
+    if (fabs(final_error) < DEADBAND_THRESHOLD && stopping && enc->stall_count == 0) {
+        // Within deadband and not stalled - close enough, stop
+        enc->has_target = 0;
+        return 1;
+    }
+    if (abs(error) < STOP_THRESHOLD) {
+        // In the window but still rolling: coast, don't chase it with reverse power
+        return 0;
+    }
+
+    // Stall detection. A wheel hunting around its target also ends up where it
+    // was half a second ago, but it is moving: boost would only widen the swing
+    if (now - enc->stall_check_time > 0.5) {
+        int32_t position_change = abs(current_relative - enc->stall_last_position);
+        if (position_change < 20 && abs(error) > 100 && fabs(enc->velocity) < SETTLE_SPEED) {
+            enc->stall_count++;
+        } else {
+            enc->stall_count = 0;
+        }
+        enc->stall_last_position = current_relative;
+        enc->stall_check_time = now;
+    }
+
+    // Release early when the coast alone will carry the wheel to the target
+    if (coast * error > 0 && fabs(coast) >= abs(error)) {
+        return 0;
+    }
+
+    // Acceleration limit: the cap ramps up from min_pwm over the start of the move
+    int max_pwm = limits->max_pwm;
+    if (limits->accel > 0) {
+        double ramp = limits->min_pwm + limits->accel * (now - enc->move_start_time);
+        if (ramp < max_pwm) max_pwm = (int)ramp;
+    }
+
+    int out;
+    if (velocity_loop_tuned(wp)) {
+        // Velocity loop: cruise speed scales with max_pwm like bang-bang
+        double cruise = wp->max_speed * max_pwm / limits->pwm_limit;
+        out = velocity_loop_update(enc, wp, error > 0 ? cruise : -cruise, now);
+    } else if (error > 0) {
+        // Simple Bang-Bang Control (No PID/Proportional)
+        out = max_pwm;
+    } else {
+        out = -max_pwm;
+    }
+
+    // Stall compensation - boost power if stuck
+    int boost = enc->stall_count * 10;
+    if (out > 0) {
+        out += boost;
+        if (out > 100) out = 100;
+    } else {
+        out -= boost;
+        if (out < -100) out = -100;
+    }
+
+    *pwm = out;
+    enc->move_pwm = out;
+    return 0;
+}
+
+int drive_sync_hold(int32_t error, int32_t other_error, int32_t target) {
+    int32_t ahead = other_error - error;
+    if (target < 0) ahead = -ahead;
+    return ahead > DRIVE_SYNC_COUNTS;
+}
+
+int drive_steer(const OdometryState *odom, double target_x, double target_y, int32_t *lead) {
+    double dx = target_x - odom->x;
+    double dy = target_y - odom->y;
+    if (hypot(dx, dy) < DRIVE_STEER_MIN_FT) return 0;
+
+    double bearing = atan2(dy, dx) * 180.0 / M_PI;
+    *lead = 2 * turn_left_counts(heading_delta(bearing, odom->heading));
+    return 1;
+}
+
+int wheels_settled(double *still_since, double left_velocity, double right_velocity, double now) {
+    if (fabs(left_velocity) > SETTLE_SPEED || fabs(right_velocity) > SETTLE_SPEED) {
+        *still_since = -1;
+        return 0;
+    }
+    if (*still_since < 0) *still_since = now;
+    return now - *still_since >= SETTLE_TIME_SEC;
+}
+
+NavState goto_plan(const OdometryState *odom, double coast_ft, double target_x, double target_y,
+                   const ArrivalProfile *profile, double *heading_diff, double *distance) {
+    double dx = target_x - odom->x;
+    double dy = target_y - odom->y;
+    double target_heading = atan2(dy, dx) * 180.0 / M_PI;
+    if (target_heading < 0) target_heading += 360.0;
+
+    double diff = target_heading - odom->heading;
+    while (diff > 180) diff -= 360;
+    while (diff < -180) diff += 360;
+
+    *heading_diff = diff;
+    *distance = sqrt(dx*dx + dy*dy);
+
+    // Where the robot ends up if nothing else is commanded
+    double heading_rad = odom->heading * M_PI / 180.0;
+    double stop_distance = hypot(dx - coast_ft * cos(heading_rad), dy - coast_ft * sin(heading_rad));
+
+    if (stop_distance < profile->distance_ft) return NAV_IDLE;
+    // Aim well enough to end the drive inside the arrival distance: far targets
+    // need a tighter heading than the profile's
+    double heading_tol = fmin(profile->heading_deg, atan2(profile->distance_ft, *distance) * 180.0 / M_PI);
+    // A turn inside the wheel stop window would finish without moving
+    if (fabs(diff) > heading_tol && calculate_turn_counts(diff) >= STOP_THRESHOLD) return NAV_TURNING;
+    return NAV_DRIVING;
+}
@@ -0,0 +1,81 @@
+#include "../include/esc.h"
+#include "../include/motor.h"
+#include <math.h>
+
+int esc_pulse_dir(int pulse_ns) {
+    if (pulse_ns > NEUTRAL_NS + 10000) return 1;
+    if (pulse_ns < NEUTRAL_NS - 10000) return -1;
+    return 0;
+}
+
+void esc_reset(EscShaper *esc) {
+    esc->phase = ESC_DRIVE;
+    esc->engaged_dir = 0;
+    esc->phase_start = 0;
+    esc->neutral_since = -1;
+}
+
+void esc_track_output(EscShaper *esc, int pulse_ns, double now) {
+    int dir = esc_pulse_dir(pulse_ns);
+    if (dir == 0) {
+        if (esc->neutral_since < 0) esc->neutral_since = now;
+    } else {
+        esc->neutral_since = -1;
+        // Brake pulses do not change the latched direction
+        if (esc->phase == ESC_DRIVE) esc->engaged_dir = dir;
+    }
+}
+
+int esc_shape(EscShaper *esc, const EscParams *p, int target_pulse_ns, double wheel_velocity, double now) {
+    int want = esc_pulse_dir(target_pulse_ns);
+
+    if ((int)p->mode == ESC_MODE_DIRECT) {
+        esc->phase = ESC_DRIVE;
+        esc_track_output(esc, target_pulse_ns, now);
+        return target_pulse_ns;
+    }
+
+    // Neutral held long enough: the ESC has released its direction lockout
+    if (esc->neutral_since >= 0 && now - esc->neutral_since >= p->neutral_dwell) {
+        esc->engaged_dir = 0;
+    }
+
+    // Abandon a reversal that is no longer wanted (stop, or same direction again)
+    if (esc->phase != ESC_DRIVE && (want == 0 || want != -esc->engaged_dir)) {
+        esc->phase = ESC_DRIVE;
+    }
+
+    // Reversal against the latched direction starts the sequence
+    if (esc->phase == ESC_DRIVE && want != 0 && want == -esc->engaged_dir) {
+        if ((int)p->mode == ESC_MODE_BRAKE && p->brake_time > 0 && fabs(wheel_velocity) > p->stop_speed) {
+            esc->phase = ESC_BRAKING;
+        } else {
+            esc->phase = ESC_NEUTRAL_DWELL;
+        }
+        esc->phase_start = now;
+    }
+
+    // Brake until the wheel has stopped, bounded by brake_time
+    if (esc->phase == ESC_BRAKING &&
+        (now - esc->phase_start >= p->brake_time || fabs(wheel_velocity) <= p->stop_speed)) {
+        esc->phase = ESC_NEUTRAL_DWELL;
+        esc->phase_start = now;
+    }
+
+    int output;
+    switch (esc->phase) {
+        case ESC_BRAKING:
+            // Opposite the latched direction, which the ESC treats as brake
+            output = NEUTRAL_NS - esc->engaged_dir * (int)p->brake_ns;
+            break;
+        case ESC_NEUTRAL_DWELL:
+            output = NEUTRAL_NS;
+            break;
+        default:
+            output = target_pulse_ns;
+            break;
+    }
+
+    esc_track_output(esc, output, now);
+    return output;
+}
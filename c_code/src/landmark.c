@@ -0,0 +1,98 @@
+#include "../include/landmark.h"
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <math.h>
+
+const Landmark landmarks[LANDMARK_COUNT] = {
+    {"red",    0.0,  0.0},
+    {"yellow", 0.0,  30.0},
+    {"blue",   30.0, 30.0},
+    {"green",  30.0, 0.0},
+};
+
+int landmark_find(const char *id) {
+    if (isdigit((unsigned char)id[0])) {
+        int index = atoi(id);
+        return (index >= 0 && index < LANDMARK_COUNT) ? index : -1;
+    }
+    for (int i = 0; i < LANDMARK_COUNT; i++) {
+        if (strcasecmp(id, landmarks[i].name) == 0) return i;
+    }
+    return -1;
+}
+
+int landmark_at(double x, double y) {
+    for (int i = 0; i < LANDMARK_COUNT; i++) {
+        if (hypot(x - landmarks[i].x, y - landmarks[i].y) < LANDMARK_TARGET_RADIUS_FT) return i;
+    }
+    return -1;
+}
+
+void odometry_grow_variance(OdometryState *odom, double distance, double turn_deg) {
+    odom->pos_var += fabs(distance) * ODOM_VAR_PER_FOOT + fabs(turn_deg) * ODOM_VAR_PER_DEG;
+}
+
+int landmark_correct(OdometryState *odom, int id, double *dx, double *dy) {
+    const Landmark *lm = &landmarks[id];
+
+    // Where the robot center must be if its bumper is touching the landmark
+    double heading_rad = odom->heading * M_PI / 180.0;
+    double meas_x = lm->x - LANDMARK_CONTACT_OFFSET_FT * cos(heading_rad);
+    double meas_y = lm->y - LANDMARK_CONTACT_OFFSET_FT * sin(heading_rad);
+
+    double innov_x = meas_x - odom->x;
+    double innov_y = meas_y - odom->y;
+    double innov = hypot(innov_x, innov_y);
+
+    // Gate: a contact far outside our uncertainty is something else (or another bucket)
+    double innov_var = odom->pos_var + LANDMARK_MEAS_VAR;
+    if (innov > LANDMARK_GATE_SIGMA * sqrt(innov_var)) {
+        *dx = innov_x;
+        *dy = innov_y;
+        return 0;
+    }
+
+    // Scalar Kalman update, same gain on both axes
+    double gain = odom->pos_var / innov_var;
+    double cx = gain * innov_x;
+    double cy = gain * innov_y;
+
+    double correction = hypot(cx, cy);
+    if (correction > LANDMARK_MAX_CORRECTION_FT) {
+        cx *= LANDMARK_MAX_CORRECTION_FT / correction;
+        cy *= LANDMARK_MAX_CORRECTION_FT / correction;
+    }
+
+    odom->x += cx;
+    odom->y += cy;
+    odom->pos_var *= (1.0 - gain);
+
+    *dx = cx;
+    *dy = cy;
+    return 1;
+}
+
+void contact_reset(ContactDetector *cd) {
+    cd->moving = 0;
+    cd->stalled_since = -1;
+}
+
+int contact_update(ContactDetector *cd, double left_velocity, double right_velocity, double now) {
+    // Ignore the start of a leg: the wheels sit still through ESC dead time and braking
+    if (!cd->moving) {
+        if (left_velocity > LANDMARK_MOVING_SPEED && right_velocity > LANDMARK_MOVING_SPEED) {
+            cd->moving = 1;
+        }
+        return 0;
+    }
+
+    if (fabs(left_velocity) < LANDMARK_STALL_SPEED && fabs(right_velocity) < LANDMARK_STALL_SPEED) {
+        if (cd->stalled_since < 0) cd->stalled_since = now;
+        return now - cd->stalled_since >= LANDMARK_STALL_TIME;
+    }
+
+    cd->stalled_since = -1;
+    return 0;
+}
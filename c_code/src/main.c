@@ -4,6 +4,13 @@
 #include "../include/imu.h"
 #include "../include/kalman.h"
 #include "../include/sensors.h"
+#include "../include/params.h"
+#include "../include/control.h"
+#include "../include/autotune.h"
+#include "../include/telemetry.h"
+#include "../include/trace.h"
+#include "../include/landmark.h"
+#include "../include/navigation.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
@@ -14,8 +21,9 @@
 
 volatile int running = 1;
 
-OdometryState odometry = {START_X, START_Y, START_HEADING, 0, 0}; // Start at (0, 15), Heading from config
-NavigationController nav_ctrl = {NAV_IDLE, 0, 0, 0, 0, 0.3}; // Default 30% speed
+OdometryState odometry = {START_X, START_Y, START_HEADING, 0, 0, ODOM_INITIAL_VAR}; // Start at (0, 15), Heading from config
+NavigationController nav_ctrl = {NAV_IDLE, 0, 0, 0, 0, 0.3, -1, ARRIVE_PRECISE, -1, 0, 0, 0, 0, 0}; // Default 30% speed
+ContactDetector bucket_contact; // Bucket contact on drive legs toward a landmark
 KalmanFilter kf_heading;
 double current_gyro_rate = 0.0;
 double last_imu_time = 0.0;
@@ -26,7 +34,6 @@ int g_min_pwm = 45;  // Minimum PWM to overcome friction
 int g_max_pwm = 80;  // Maximum PWM for control stability
 
 void dump_log(); // Forward declare
-int32_t calculate_turn_counts(double degrees);
 void update_odometry(void);
 
 
@@ -40,37 +47,6 @@ void signal_handler(int sig) {
 // --- Logging System ---
 #define LOG_SIZE 1000000 // ~48MB RAM for logs, ~1.4 hrs at 200Hz. Reduced from 15M to prevent OOM.
 
-// Control modes for logging
-typedef enum {
-    MODE_IDLE = 0,
-    MODE_JOYSTICK = 1,    // Direct pulse commands
-    MODE_VOICE_NAV = 2    // Autonomous goto commands
-} ControlMode;
-
-typedef struct {
-    double time;
-    int32_t target_l;
-    int32_t actual_l;
-    int pulse_l; 
-    int raw_l;
-    int32_t target_r;
-    int32_t actual_r;
-    int pulse_r; 
-    int raw_r;
-    char mode; // Control mode: 0=IDLE, 1=JOYSTICK, 2=VOICE_NAV
-    
-    // IMU data
-    double gyro_z;        // Z-axis gyro rate (degrees/sec)
-    
-    // Odometry data
-    double odom_x;        // X position (feet)
-    double odom_y;        // Y position (feet)
-    double odom_heading;  // Heading (degrees)
-    
-    // Navigation state
-    char nav_state;       // 0=IDLE, 1=PLANNING, 2=TURNING, 3=DRIVING
-} LogEntry;
-
 LogEntry *log_buffer = NULL;
 int log_index = 0;
 ControlMode current_mode = MODE_IDLE;
@@ -85,40 +61,43 @@ void init_log_system() {
 }
 
 void log_data(double time) {
-    if (!log_buffer || log_index >= LOG_SIZE) return;
-
     // Capture state safely
-    LogEntry *entry = &log_buffer[log_index];
-    entry->time = time;
-    entry->mode = (char)current_mode;
+    LogEntry entry;
+    entry.time = time;
+    entry.mode = (char)current_mode;
 
     pthread_mutex_lock(&motors[0].lock);
-    entry->target_l = encoders[0].target_counts;
-    entry->actual_l = encoders[0].total_counts + (encoders[0].current_raw_angle - encoders[0].start_raw_angle);
-    entry->pulse_l = motors[0].last_pulse_ns;
-    entry->raw_l = encoders[0].current_raw_angle;
+    entry.target_l = encoders[0].target_counts;
+    entry.actual_l = wheel_move_position(&encoders[0]); // Same frame as target
+    entry.pulse_l = motors[0].last_pulse_ns;
+    entry.raw_l = encoders[0].current_raw_angle;
     pthread_mutex_unlock(&motors[0].lock);
 
     pthread_mutex_lock(&motors[1].lock);
-    entry->target_r = encoders[1].target_counts;
-    entry->actual_r = encoders[1].total_counts + (encoders[1].current_raw_angle - encoders[1].start_raw_angle);
-    entry->pulse_r = motors[1].last_pulse_ns;
-    entry->raw_r = encoders[1].current_raw_angle;
+    entry.target_r = encoders[1].target_counts;
+    entry.actual_r = wheel_move_position(&encoders[1]);
+    entry.pulse_r = motors[1].last_pulse_ns;
+    entry.raw_r = encoders[1].current_raw_angle;
     pthread_mutex_unlock(&motors[1].lock);
 
     // Capture IMU data
     pthread_mutex_lock(&imu_data_lock);
-    entry->gyro_z = current_gyro_rate;
+    entry.gyro_z = current_gyro_rate;
     pthread_mutex_unlock(&imu_data_lock);
 
     // Capture odometry data (odometry is updated in coordinated_control_thread)
-    entry->odom_x = odometry.x;
-    entry->odom_y = odometry.y;
-    entry->odom_heading = odometry.heading;
+    entry.odom_x = odometry.x;
+    entry.odom_y = odometry.y;
+    entry.odom_heading = odometry.heading;
 
     // Capture navigation state
-    entry->nav_state = (char)nav_ctrl.state;
+    entry.nav_state = (char)nav_ctrl.state;
 
+    // Live view (always, even after the run buffer has been dumped)
+    telemetry_ring_push(&entry);
+
+    if (!log_buffer || log_index >= LOG_SIZE) return;
+    log_buffer[log_index] = entry;
     log_index++;
 }
 
@@ -238,6 +217,49 @@ void dump_log() {
 }
 
 // --- Coordinated Control Thread ---
+
+// Print and trace what a navigation step did (nav_step events)
+static void nav_report(const NavStep *step, NavState before) {
+    if (!step->events) return;
+
+    if (step->events & NAV_EVENT_TURN) trace_event("nav_turn", "%.1f", step->heading_diff);
+    if (step->events & NAV_EVENT_DRIVE) trace_event("nav_drive", "%.2f", step->distance);
+    if (step->events & NAV_EVENT_MOVE_DONE) {
+        trace_event("move_done", "%s", before == NAV_TURNING ? "turn" : "drive");
+    }
+    if (step->events & NAV_EVENT_WRONG_WAY) {
+        fprintf(stderr, "ERROR: Turn toward %.1f went the wrong way (%.1f -> %.1f), check TURN_LEFT_FORWARD_SIGN\n",
+                nav_ctrl.target_heading, nav_ctrl.turn_start_heading, odometry.heading);
+        trace_event("nav_wrong_way", "%.1f %.1f", nav_ctrl.turn_start_heading, odometry.heading);
+        printf("NAVERROR turn %.1f %.1f\n", nav_ctrl.turn_start_heading, odometry.heading);
+    }
+    if (step->events & NAV_EVENT_REJECTED) {
+        fprintf(stderr, "Contact rejected as %s landmark (off by %.2f ft)%s\n",
+                landmarks[nav_ctrl.target_landmark].name, hypot(step->dx, step->dy),
+                (step->events & NAV_EVENT_ARRIVED) ? ", arrived at the bucket without a fix" : "");
+    }
+    if (step->events & NAV_EVENT_STALLED) {
+        fprintf(stderr, "ERROR: %s stalled short of (%.2f, %.2f) at (%.2f, %.2f), GOTO stopped\n",
+                before == NAV_TURNING ? "Turn" : "Drive", nav_ctrl.target_x, nav_ctrl.target_y, odometry.x, odometry.y);
+        trace_event("nav_stalled", "%.2f %.2f", odometry.x, odometry.y);
+        printf("NAVERROR stall %.2f %.2f\n", odometry.x, odometry.y);
+    }
+    if (step->events & NAV_EVENT_LANDMARK) {
+        const Landmark *lm = &landmarks[nav_ctrl.target_landmark];
+        trace_event("landmark", "%s contact %.2f %.2f", lm->name, step->dx, step->dy);
+        printf("LANDMARK %s contact %.2f %.2f %.3f\n", lm->name, step->dx, step->dy, sqrt(odometry.pos_var));
+    } else if (step->events & NAV_EVENT_ARRIVED) {
+        trace_event("nav_arrived", "%.2f %.2f", odometry.x, odometry.y);
+    }
+    if (step->events & NAV_EVENT_ARRIVED) printf("ARRIVED\n");
+
+    // Immediate STATUS on every state change, so Python follows the GOTO
+    if (step->events & ~NAV_EVENT_REJECTED) {
+        printf("STATUS %.2f %.2f %.2f %d\n", odometry.x, odometry.y, odometry.heading, nav_ctrl.state);
+    }
+    fflush(stdout);
+}
+
 void* coordinated_control_thread(void* arg) {
     (void)arg;
     int sleep_us = 1000000 / 200; // 200Hz control loop
@@ -253,231 +275,30 @@ void* coordinated_control_thread(void* arg) {
                 // Do nothing
                 break;
 
-            case NAV_GOTO: {
-                // Determine next step: Turn or Drive
-                double dx = nav_ctrl.target_x - odometry.x;
-                double dy = nav_ctrl.target_y - odometry.y;
-                double target_heading = atan2(dy, dx) * 180.0 / M_PI;
-                if (target_heading < 0) target_heading += 360.0;
-
-                double heading_diff = target_heading - odometry.heading;
-                while (heading_diff > 180) heading_diff -= 360;
-                while (heading_diff < -180) heading_diff += 360;
-
-                double distance = sqrt(dx*dx + dy*dy);
-
-                if (distance < 1.0) { // Tolerance 1ft
-                    printf("ARRIVED\n");
-                    fflush(stdout);
-                    nav_ctrl.state = NAV_IDLE;
-
-                    // Send immediate STATUS update so Python knows we arrived
-                    printf("STATUS %.2f %.2f %.2f %d\n", odometry.x, odometry.y, odometry.heading, nav_ctrl.state);
-                    fflush(stdout);
-                } else if (fabs(heading_diff) > 5.0) { // Turn required
-                    nav_ctrl.state = NAV_TURNING;
-                    nav_ctrl.target_heading = target_heading;
-
-                    // Reset Encoders for local move
-                    pthread_mutex_lock(&motors[0].lock);
-                    encoders[0].move_start_counts = encoders[0].total_counts; // Capture start position
-                    encoders[0].target_counts = calculate_turn_counts(heading_diff);
-                    encoders[0].has_target = 1;
-                    encoders[0].stall_count = 0;
-                    encoders[0].stall_check_time = current_time;
-                    encoders[0].stall_last_position = 0;
-                    pthread_mutex_unlock(&motors[0].lock);
-
-                    pthread_mutex_lock(&motors[1].lock);
-                    encoders[1].move_start_counts = encoders[1].total_counts; // Capture start position
-                    encoders[1].target_counts = -calculate_turn_counts(heading_diff); // Differential
-                    encoders[1].has_target = 1;
-                    encoders[1].stall_count = 0;
-                    encoders[1].stall_check_time = current_time;
-                    encoders[1].stall_last_position = 0;
-                    pthread_mutex_unlock(&motors[1].lock);
-
-                    // Send immediate STATUS to notify Python we started turning
-                    printf("STATUS %.2f %.2f %.2f %d\n", odometry.x, odometry.y, odometry.heading, nav_ctrl.state);
-                    fflush(stdout);
-
-                } else { // Drive required
-                    nav_ctrl.state = NAV_DRIVING;
-                    nav_ctrl.target_distance = distance;
-
-                    // Reset Encoders for local move
-                    int32_t counts = (int32_t)(distance * COUNTS_PER_FOOT);
-                    pthread_mutex_lock(&motors[0].lock);
-// encoders[0].start_raw_angle = encoders[0].current_raw_angle; // REMOVED
-                    // encoders[0].rotation_count = 0; // REMOVED
-                    // encoders[0].total_counts = 0; // REMOVED
-                    encoders[0].move_start_counts = encoders[0].total_counts;
-                    encoders[0].target_counts = counts;
-                    encoders[0].has_target = 1;
-                    encoders[0].stall_count = 0;
-                    encoders[0].stall_check_time = current_time;
-                    encoders[0].stall_last_position = 0;
-                    pthread_mutex_unlock(&motors[0].lock);
-
-                    pthread_mutex_lock(&motors[1].lock);
-// encoders[1].start_raw_angle = encoders[1].current_raw_angle; // REMOVED
-                    // encoders[1].rotation_count = 0; // REMOVED
-                    // encoders[1].total_counts = 0; // REMOVED
-                    encoders[1].move_start_counts = encoders[1].total_counts;
-                    encoders[1].target_counts = counts;
-                    encoders[1].has_target = 1;
-                    encoders[1].stall_count = 0;
-                    encoders[1].stall_check_time = current_time;
-                    encoders[1].stall_last_position = 0;
-                    pthread_mutex_unlock(&motors[1].lock);
-
-                    // Send immediate STATUS to notify Python we started driving
-                    printf("STATUS %.2f %.2f %.2f %d\n", odometry.x, odometry.y, odometry.heading, nav_ctrl.state);
-                    fflush(stdout);
-                }
-                break;
-            }
-
+            case NAV_GOTO:
             case NAV_TURNING:
             case NAV_DRIVING: {
-                int left_done = 0, right_done = 0;
-
-                // Simple on/off control - no proportional deceleration
-                // Use global PWM limits (can be adjusted via setpwm command)
-                // Apply speed multiplier from slider (0.0 - 1.0)
-                int MAX_PWM = (int)(g_max_pwm * nav_ctrl.speed_multiplier);
-                if (MAX_PWM < g_min_pwm) MAX_PWM = g_min_pwm; // Ensure we can move
-
-                // Check Left
-                 pthread_mutex_lock(&motors[0].lock);
-                 if (encoders[0].has_target) {
-                     // Calculate relative position and error
-                    int32_t current_relative = (encoders[0].total_counts + (encoders[0].current_raw_angle - encoders[0].start_raw_angle)) - encoders[0].move_start_counts;
-                    int32_t error = encoders[0].target_counts - current_relative;
-
-                    if (abs(error) < STOP_THRESHOLD) {
-                        // Within stop threshold - we're done
-                        set_motor_speed(0, 0, 1);
-                        encoders[0].has_target = 0;
-                        encoders[0].stall_count = 0;
-                        left_done = 1;
-                    } else if (abs(error) < DEADBAND_THRESHOLD && encoders[0].stall_count == 0) {
-                        // Within deadband and not stalled - close enough, stop
-                        set_motor_speed(0, 0, 1);
-                        encoders[0].has_target = 0;
-                        left_done = 1;
-                    } else {
-                        // Stall detection
-                        double current_time = get_time_sec();
-                        
-                        if (current_time - encoders[0].stall_check_time > 0.5) {
-                            // Using current_relative for stall check is fine as it moves same as absolute
-                            int32_t position_change = abs(current_relative - encoders[0].stall_last_position);
-                            if (position_change < 20 && abs(error) > 100) {
-                                encoders[0].stall_count++;
-                                fprintf(stderr, "Left motor stalled (count: %d), error: %d\n", encoders[0].stall_count, error);
-                            } else {
-                                encoders[0].stall_count = 0;
-                            }
-                            encoders[0].stall_last_position = current_relative;
-                            encoders[0].stall_check_time = current_time;
-                        }
-
-                        // Simple Bang-Bang Control (No PID/Proportional)
-                        int pwm;
-                        
-                        if (error > 0) {
-                            pwm = MAX_PWM;
-                        } else {
-                            pwm = -MAX_PWM;
-                        }
-
-                        // Stall compensation - boost power if stuck
-                        int boost = encoders[0].stall_count * 10;
-                        if (pwm > 0) {
-                            pwm += boost;
-                            if (pwm > 100) pwm = 100;
-                        } else {
-                            pwm -= boost;
-                            if (pwm < -100) pwm = -100;
-                        }
-
-                        set_motor_speed(0, pwm, 1);
+                const char *wheel_names[2] = {"Left", "Right"};
+                NavState before = nav_ctrl.state;
+                NavStep step;
+
+                // Both wheels under their locks: the step plans and runs moves on the pair
+                pthread_mutex_lock(&motors[0].lock);
+                pthread_mutex_lock(&motors[1].lock);
+                nav_step(&nav_ctrl, &bucket_contact, encoders, &odometry, &motor_params,
+                         g_min_pwm, g_max_pwm, current_time, &step);
+                for (int i = 0; i < 2; i++) {
+                    set_motor_speed(i, step.pwm[i], 1);
+                    if (step.stalled[i]) {
+                        fprintf(stderr, "%s motor stalled (count: %d), error: %d\n",
+                                wheel_names[i], encoders[i].stall_count, wheel_move_error(&encoders[i]));
                     }
-                 } else {
-                     set_motor_speed(0, 0, 1);
-                     left_done = 1;
-                 }
-                 pthread_mutex_unlock(&motors[0].lock);
-
-                 // Check Right
-                 pthread_mutex_lock(&motors[1].lock);
-                 if (encoders[1].has_target) {
-                    // Calculate relative position and error
-                    int32_t current_relative = (encoders[1].total_counts + (encoders[1].current_raw_angle - encoders[1].start_raw_angle)) - encoders[1].move_start_counts;
-                    int32_t error = encoders[1].target_counts - current_relative;
-
-                    if (abs(error) < STOP_THRESHOLD) {
-                        // Within stop threshold - we're done
-                        set_motor_speed(1, 0, 1);
-                        encoders[1].has_target = 0;
-                        encoders[1].stall_count = 0;
-                        right_done = 1;
-                    } else if (abs(error) < DEADBAND_THRESHOLD && encoders[1].stall_count == 0) {
-                        // Within deadband and not stalled - close enough, stop
-                        set_motor_speed(1, 0, 1);
-                        encoders[1].has_target = 0;
-                        right_done = 1;
-                    } else {
-                        // Stall detection
-                        double current_time = get_time_sec(); 
-                        if (current_time - encoders[1].stall_check_time > 0.5) {
-                            int32_t position_change = abs(current_relative - encoders[1].stall_last_position);
-                            if (position_change < 20 && abs(error) > 100) {
-                                encoders[1].stall_count++;
-                                fprintf(stderr, "Right motor stalled (count: %d), error: %d\n", encoders[1].stall_count, error);
-                            } else {
-                                encoders[1].stall_count = 0;
-                            }
-                            encoders[1].stall_last_position = current_relative;
-                            encoders[1].stall_check_time = current_time;
-                        }
-
-                         // Simple Bang-Bang Control (No PID/Proportional)
-                        int pwm;
-                        
-                        if (error > 0) {
-                            pwm = MAX_PWM;
-                        } else {
-                            pwm = -MAX_PWM;
-                        }
-
-                        // Stall compensation - boost power if stuck
-                        int boost = encoders[1].stall_count * 10;
-                        if (pwm > 0) {
-                            pwm += boost;
-                            if (pwm > 100) pwm = 100;
-                        } else {
-                            pwm -= boost;
-                            if (pwm < -100) pwm = -100;
-                        }
-
-                        set_motor_speed(1, pwm, 1);
-                    }
-                 } else {
-                     set_motor_speed(1, 0, 1);
-                     right_done = 1;
-                 }
-                 pthread_mutex_unlock(&motors[1].lock);
-
-                 if (left_done && right_done) {
-                     nav_ctrl.state = NAV_GOTO; // Re-evaluate
-
-                     // Send immediate STATUS to notify Python of state change
-                     printf("STATUS %.2f %.2f %.2f %d\n", odometry.x, odometry.y, odometry.heading, nav_ctrl.state);
-                     fflush(stdout);
-                 }
-                 break;
+                }
+                pthread_mutex_unlock(&motors[1].lock);
+                pthread_mutex_unlock(&motors[0].lock);
+
+                nav_report(&step, before);
+                break;
             }
         }
 
@@ -529,16 +350,15 @@ void update_encoder_rotation(EncoderState *enc, int16_t raw_angle, int motor_id)
     
     // Detect rotation completion by monitoring boundary crossings
     // Both motors use the same logic (encoders are not inverted)
-    if (enc->motor_state == 1) {
-        // Forward motion: crossing from high (>3000) to low (<1000)
-        if (enc->last_raw_angle > 3000 && raw_angle < 1000) {
-            enc->rotation_count++;
-        }
-    } else if (enc->motor_state == -1) {
-        // Reverse motion: crossing from low (<1000) to high (>3000)
-        if (enc->last_raw_angle < 1000 && raw_angle > 3000) {
-            enc->rotation_count--;
-        }
+    // Direction comes from the angle jump, not the commanded PWM: while the ESC
+    // brakes or dwells at neutral the wheel keeps coasting the old way.
+    int angle_jump = raw_angle - enc->last_raw_angle;
+    if (angle_jump < -COUNTS_PER_REV / 2) {
+        // Forward motion: wrapped from high to low
+        enc->rotation_count++;
+    } else if (angle_jump > COUNTS_PER_REV / 2) {
+        // Reverse motion: wrapped from low to high
+        enc->rotation_count--;
     }
     
     // Update state
@@ -574,6 +394,7 @@ void* encoder_feedback_thread(void* arg) {
         if (left_angle >= 0) {
             pthread_mutex_lock(&motors[0].lock);
             update_encoder_rotation(&encoders[0], left_angle, 0);
+            update_encoder_velocity(&encoders[0], sensors.timestamp);
             pthread_mutex_unlock(&motors[0].lock);
         }
 
@@ -581,6 +402,7 @@ void* encoder_feedback_thread(void* arg) {
         if (right_angle >= 0) {
             pthread_mutex_lock(&motors[1].lock);
             update_encoder_rotation(&encoders[1], right_angle, 1);
+            update_encoder_velocity(&encoders[1], sensors.timestamp);
             pthread_mutex_unlock(&motors[1].lock);
         }
 
@@ -590,14 +412,11 @@ void* encoder_feedback_thread(void* arg) {
     return NULL;
 }
 
-int32_t calculate_turn_counts(double degrees) {
-    double arc_length = (fabs(degrees) / 360.0) * M_PI * WHEELBASE_INCHES;
-    return (int32_t)(arc_length * COUNTS_PER_INCH);
-}
-
 // --- Fusion Odometry ---
 void update_odometry(void) {
     static int first_update = 1;
+    static int32_t anchor_left, anchor_right;
+    static double last_motion_time = -1.0;
     
     double current_time = get_time_sec();
     double dt = current_time - last_imu_time;
@@ -607,6 +426,8 @@ void update_odometry(void) {
     if (first_update) {
         odometry.last_left_total = encoders[0].total_counts;
         odometry.last_right_total = encoders[1].total_counts;
+        anchor_left = odometry.last_left_total;
+        anchor_right = odometry.last_right_total;
         first_update = 0;
         return;  // Skip first update to avoid spurious delta
     }
@@ -646,12 +467,20 @@ void update_odometry(void) {
     double delta_heading = 0.0;
     
     // Check if robot is moving (either wheel has moved)
-    if (fabs(center_dist) > 0.001) {  // More than 0.001 feet movement
+    // Not center_dist: it stays near zero through an in-place turn
+    if (abs(encoders[0].total_counts - anchor_left) > ODOM_MOTION_COUNTS ||
+        abs(encoders[1].total_counts - anchor_right) > ODOM_MOTION_COUNTS) {
+        anchor_left = encoders[0].total_counts;
+        anchor_right = encoders[1].total_counts;
+        last_motion_time = current_time;
+    }
+    if (last_motion_time >= 0 && current_time - last_motion_time < ODOM_MOTION_HOLD_SEC) {
         delta_heading = gyro_rate * dt_seconds;
     }
     
     // Update heading
     double new_heading = odometry.heading + delta_heading;
+    odometry_grow_variance(&odometry, center_dist, delta_heading);
 
     // 5. Update Odometry State
     // Use the average heading during the interval for position update
@@ -678,15 +507,25 @@ void process_command(char* cmd) {
     // Debug logging to trace command reception
     fprintf(stderr, "DEBUG: Received command: '%s'\n", cmd);
     fflush(stderr);
+    trace_event("cmd_recv", "%s", cmd);
 
     if (strncasecmp(cmd, "goto", 4) == 0) {
-        double x, y;
-        if (sscanf(cmd + 4, "%lf %lf", &x, &y) == 2) {
+        // goto x y [precise|pass] [drive speed cap 0-1, 0 = slider] [accel %/s, 0 = none]
+        double x, y, leg_speed = 0.0, leg_accel = 0.0;
+        char mode_str[16] = "precise";
+        int fields = sscanf(cmd + 4, "%lf %lf %15s %lf %lf", &x, &y, mode_str, &leg_speed, &leg_accel);
+        int arrival = arrival_find(mode_str);
+        if (leg_speed < 0.0) leg_speed = 0.0;
+        if (leg_speed > 1.0) leg_speed = 1.0;
+        if (leg_accel < 0.0) leg_accel = 0.0;
+        if (fields >= 2 && arrival < 0) {
+            printf("ERROR: Unknown arrival mode '%s' (precise, pass)\n", mode_str);
+            fflush(stdout);
+        } else if (fields >= 2) {
+            autotune_abort(); // Navigation takes over the motors
             current_mode = MODE_VOICE_NAV; // Voice control mode
-            nav_ctrl.target_x = x;
-            nav_ctrl.target_y = y;
-            nav_ctrl.state = NAV_GOTO;
-            printf("OK goto %.2f %.2f\n", x, y);
+            nav_start_goto(&nav_ctrl, x, y, arrival, leg_speed, leg_accel);
+            printf("OK goto %.2f %.2f %s %.2f %.0f\n", x, y, arrival_profiles[arrival].name, leg_speed, leg_accel);
             fflush(stdout);
 
             // Send immediate STATUS update so Python knows state changed
@@ -730,6 +569,7 @@ void process_command(char* cmd) {
             odometry.x = x;
             odometry.y = y;
             odometry.heading = h;
+            odometry.pos_var = ODOM_INITIAL_VAR;
             // Also reset accumulation to avoid jumps
             odometry.last_left_total = encoders[0].total_counts;
             odometry.last_right_total = encoders[1].total_counts;
@@ -741,7 +581,47 @@ void process_command(char* cmd) {
             fflush(stdout);
         }
     }
+    else if (strncasecmp(cmd, "landmark", 8) == 0) {
+        // landmark <name|index> - robot is touching a known bucket, correct the pose
+        char id_str[16];
+        if (sscanf(cmd + 8, "%15s", id_str) == 1) {
+            int id = landmark_find(id_str);
+            double dx, dy;
+            if (id < 0) {
+                printf("ERROR landmark unknown %s\n", id_str);
+            } else if (landmark_correct(&odometry, id, &dx, &dy)) {
+                trace_event("landmark", "%s command %.2f %.2f", landmarks[id].name, dx, dy);
+                printf("OK landmark %s %.2f %.2f %.3f\n", landmarks[id].name, dx, dy, sqrt(odometry.pos_var));
+                printf("STATUS %.2f %.2f %.2f %d\n", odometry.x, odometry.y, odometry.heading, nav_ctrl.state);
+            } else {
+                printf("ERROR landmark %s rejected, %.2f ft from odometry\n", landmarks[id].name, hypot(dx, dy));
+            }
+            fflush(stdout);
+        }
+    }
+    else if (strncasecmp(cmd, "autotune", 8) == 0) {
+        // autotune [lifted|floor] - relay test of both wheel velocity loops
+        char mode_str[16] = "lifted";
+        sscanf(cmd + 8, "%15s", mode_str);
+        AutotuneMode mode = (strcasecmp(mode_str, "floor") == 0) ? AUTOTUNE_FLOOR : AUTOTUNE_LIFTED;
+
+        // Release the motors from navigation
+        nav_ctrl.state = NAV_IDLE;
+        for (int i = 0; i < 2; i++) {
+            pthread_mutex_lock(&motors[i].lock);
+            encoders[i].has_target = 0;
+            pthread_mutex_unlock(&motors[i].lock);
+        }
+
+        if (autotune_start(mode, g_min_pwm, g_max_pwm) == 0) {
+            printf("OK autotune %s\n", mode == AUTOTUNE_FLOOR ? "floor" : "lifted");
+        } else {
+            printf("ERROR autotune already running\n");
+        }
+        fflush(stdout);
+    }
     else if (strncasecmp(cmd, "stop", 4) == 0) {
+        autotune_abort();
         current_mode = MODE_IDLE; // Stopped/idle mode
         nav_ctrl.state = NAV_IDLE;
         for (int i = 0; i < 2; i++) {
@@ -765,6 +645,7 @@ void process_command(char* cmd) {
     else if (strncasecmp(cmd, "pulse", 5) == 0) {
         int left_ns, right_ns;
         if (sscanf(cmd + 5, "%d %d", &left_ns, &right_ns) == 2) {
+            autotune_abort(); // Joystick takes over the motors
             current_mode = MODE_JOYSTICK; // Joystick/manual control mode
 
             // Disable navigation
@@ -788,16 +669,20 @@ void process_command(char* cmd) {
 
 
             // Write pulse widths directly (Protected by locks)
+            // Raw pulses bypass ESC sequencing, but keep its direction state current
+            double now = get_time_sec();
             pthread_mutex_lock(&motors[0].lock);
             lseek(motors[0].pwm_duty_fd, 0, SEEK_SET);
             dprintf(motors[0].pwm_duty_fd, "%d", left_ns);
             motors[0].last_pulse_ns = left_ns;
+            esc_track_output(&motors[0].esc, left_ns, now);
             pthread_mutex_unlock(&motors[0].lock);
 
             pthread_mutex_lock(&motors[1].lock);
             lseek(motors[1].pwm_duty_fd, 0, SEEK_SET);
             dprintf(motors[1].pwm_duty_fd, "%d", right_ns);
             motors[1].last_pulse_ns = right_ns;
+            esc_track_output(&motors[1].esc, right_ns, now);
             pthread_mutex_unlock(&motors[1].lock);
 
 
@@ -819,10 +704,17 @@ void* command_input_thread(void* arg) {
     return NULL;
 }
 
-int main(void) {
+int main(int argc, char *argv[]) {
     signal(SIGINT, signal_handler);
     signal(SIGTERM, signal_handler);
 
+    // --trace: write timeline events for tools/trace_merge.py
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--trace") == 0) {
+            trace_open(TRACE_CONTROLLER_PATH);
+        }
+    }
+
     if (i2c_init() < 0) {
         fprintf(stderr, "ERROR: I2C init failed\n");
         return 1;
@@ -835,6 +727,19 @@ int main(void) {
     }
 
     init_log_system();
+    if (telemetry_ring_open() < 0) {
+        fprintf(stderr, "WARNING: Live telemetry unavailable\n");
+    }
+
+    // Load identified motor model (tools/motor_sysid.py), fall back to defaults
+    params_set_defaults(&motor_params);
+    int param_count = params_load(&motor_params, PARAMS_FILE);
+    if (param_count < 0) {
+        printf("No parameter file at %s, using default motor model\n", PARAMS_FILE);
+    } else {
+        printf("Loaded %d parameters from %s\n", param_count, PARAMS_FILE);
+    }
+    params_print(&motor_params);
 
     // Initialize IMU
     if (imu_init() < 0) {
@@ -865,6 +770,11 @@ int main(void) {
         encoders[i].stall_last_position = 0;
         encoders[i].stall_check_time = 0;
         encoders[i].stall_count = 0;
+
+        encoders[i].velocity = 0;
+        encoders[i].velocity_time = 0;
+        encoders[i].velocity_position = 0;
+        velocity_loop_reset(&encoders[i]);
     }
 
     pthread_mutex_init(&motors[0].lock, NULL);
@@ -891,6 +801,8 @@ int main(void) {
 
     pwm_cleanup();
     i2c_cleanup();
+    telemetry_ring_close();
+    trace_close();
 
     return 0;
 }
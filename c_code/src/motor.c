@@ -1,5 +1,7 @@
 #include "../include/motor.h"
 #include "../include/common.h"
+#include "../include/params.h"
+#include "../include/control.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
@@ -63,6 +65,7 @@ int pwm_init(void) {
 
         motors[i].last_pulse_ns = NEUTRAL_NS;
         motors[i].last_speed_update_time = 0;
+        esc_reset(&motors[i].esc);
 
         pthread_mutex_init(&motors[i].lock, NULL);
     }
@@ -76,17 +79,7 @@ void set_motor_speed(int motor_id, int speed_percent, int immediate) {
     if (speed_percent < -100) speed_percent = -100;
 
     // Convert target speed_percent to target_pulse_ns
-    // Account for ESC deadband: forward starts at 1550us, reverse at 1450us
-    int target_pulse_ns;
-    if (speed_percent > 0) {
-        // Map 0-100% to FORWARD_START_NS to FORWARD_MAX_NS
-        target_pulse_ns = FORWARD_START_NS + (speed_percent * (FORWARD_MAX_NS - FORWARD_START_NS)) / 100;
-    } else if (speed_percent < 0) {
-        // Map 0-(-100%) to REVERSE_START_NS to REVERSE_MAX_NS
-        target_pulse_ns = REVERSE_START_NS - (abs(speed_percent) * (REVERSE_START_NS - REVERSE_MAX_NS)) / 100;
-    } else {
-        target_pulse_ns = NEUTRAL_NS;
-    }
+    int target_pulse_ns = pulse_from_percent(speed_percent);
 
     // Explicit Check: Clamp to absolute limits
     if (target_pulse_ns > FORWARD_MAX_NS) target_pulse_ns = FORWARD_MAX_NS;
@@ -121,6 +114,11 @@ void set_motor_speed(int motor_id, int speed_percent, int immediate) {
         current_pulse_ns = target_pulse_ns;
     }
     
+    // Sequence direction changes the way the ESC accepts them (brake/neutral/reverse)
+    // Ramp state tracks the shaped pulse, since that is what the ESC actually sees
+    current_pulse_ns = esc_shape(&motors[motor_id].esc, &motor_params.esc, current_pulse_ns,
+                                 encoders[motor_id].velocity, current_time);
+
     // Save state
     motors[motor_id].last_pulse_ns = current_pulse_ns;
     motors[motor_id].last_speed_update_time = current_time;
@@ -0,0 +1,185 @@
+#include "../include/navigation.h"
+#include "../include/control.h"
+#include <math.h>
+#include <string.h>
+
+void nav_start_goto(NavigationController *nav, double x, double y, int arrival, double speed, double accel) {
+    nav->target_x = x;
+    nav->target_y = y;
+    nav->target_landmark = landmark_at(x, y);
+    nav->arrival = arrival;
+    nav->settle_since = -1;
+    nav->first_move = 1;
+    nav->leg_speed = speed;
+    nav->leg_accel = accel;
+    nav->state = NAV_GOTO;
+}
+
+// End the current move on both wheels
+static void stop_wheels(EncoderState enc[2], NavStep *out) {
+    for (int i = 0; i < 2; i++) {
+        enc[i].has_target = 0;
+        enc[i].stall_count = 0;
+        out->pwm[i] = 0;
+    }
+}
+
+// NAV_GOTO: arrive, or start the next turn or drive
+static void nav_plan(NavigationController *nav, ContactDetector *contact, EncoderState enc[2],
+                     const OdometryState *odom, const MotorParams *params, double now, NavStep *out) {
+    const ArrivalProfile *profile = &arrival_profiles[nav->arrival];
+    double coast_ft = 0.5 * (wheel_stop_distance(&enc[0], &params->wheel[0]) +
+                             wheel_stop_distance(&enc[1], &params->wheel[1])) / COUNTS_PER_FOOT;
+    double heading_diff, distance;
+    NavState next = goto_plan(odom, coast_ft, nav->target_x, nav->target_y, profile, &heading_diff, &distance);
+
+    // Precise targets plan from a stopped robot, so the pose and the next move are exact.
+    // Coming in lined up from a pass leg, the first drive starts without stopping
+    int roll_on = nav->first_move && next == NAV_DRIVING;
+    if (profile->settle && !roll_on &&
+        !wheels_settled(&nav->settle_since, enc[0].velocity, enc[1].velocity, now)) {
+        return;
+    }
+    if (next != NAV_IDLE) nav->first_move = 0;
+
+    if (next == NAV_IDLE) {
+        nav->state = NAV_IDLE;
+        out->events |= NAV_EVENT_ARRIVED;
+    } else if (next == NAV_TURNING) {
+        int32_t counts = turn_left_counts(heading_diff);
+        nav->state = NAV_TURNING;
+        nav->target_heading = fmod(odom->heading + heading_diff + 360.0, 360.0);
+        nav->turn_start_heading = odom->heading;
+        wheel_move_start(&enc[0], counts, now);
+        wheel_move_start(&enc[1], -counts, now); // Differential
+        out->heading_diff = heading_diff;
+        out->events |= NAV_EVENT_TURN;
+    } else {
+        int32_t counts = (int32_t)(distance * COUNTS_PER_FOOT);
+        nav->state = NAV_DRIVING;
+        nav->target_distance = distance;
+        nav->drive_lead = 0;
+        contact_reset(contact);
+        wheel_move_start(&enc[0], counts, now);
+        wheel_move_start(&enc[1], counts, now);
+        out->distance = distance;
+        out->events |= NAV_EVENT_DRIVE;
+    }
+}
+
+// NAV_TURNING / NAV_DRIVING: one step of the move on both wheels
+static void nav_move(NavigationController *nav, ContactDetector *contact, EncoderState enc[2],
+                     OdometryState *odom, const MotorParams *params, int min_pwm, int max_pwm,
+                     double now, NavStep *out) {
+    // The slider (0.0 - 1.0) sets the speed; a leg's speed caps its drives below it.
+    // Turns stay at the slider, fast turns overshoot the heading the drive depends on
+    double speed = nav->speed_multiplier;
+    if (nav->state == NAV_DRIVING && nav->leg_speed > 0) speed = fmin(speed, nav->leg_speed);
+
+    // Turns always end stopped (the drive needs the final heading);
+    // drives to a pass-through waypoint end rolling
+    int settle = nav->state == NAV_TURNING || arrival_profiles[nav->arrival].settle;
+    MoveLimits limits = move_limits(min_pwm, max_pwm, speed, nav->leg_accel, settle);
+
+    // Drives keep the wheels' progress level (drive_sync_hold), with the left
+    // wheel drive_lead ahead: while the target is far, the lead that steers the
+    // heading onto it (drive_steer), after that the lead it ended on
+    int sync = nav->state == NAV_DRIVING && enc[0].has_target && enc[1].has_target;
+    int32_t drive_error[2] = {wheel_move_error(&enc[0]), wheel_move_error(&enc[1])};
+    int32_t steer;
+    if (sync && drive_steer(odom, nav->target_x, nav->target_y, &steer)) {
+        nav->drive_lead = drive_error[1] - drive_error[0] + steer;
+    }
+    drive_error[0] += nav->drive_lead;
+
+    int done = 1;
+    for (int i = 0; i < 2; i++) {
+        if (!enc[i].has_target) {
+            out->pwm[i] = 0;
+            continue;
+        }
+        int stalls = enc[i].stall_count;
+        int wheel_done = wheel_move_step(&enc[i], &params->wheel[i], &limits, now, &out->pwm[i]);
+        out->stalled[i] = enc[i].stall_count > stalls;
+        if (sync && !wheel_done && drive_sync_hold(drive_error[i], drive_error[1 - i], enc[i].target_counts)) {
+            out->pwm[i] = 0;
+            enc[i].move_pwm = 0; // Coasting, for the stop prediction
+        }
+        done &= wheel_done;
+    }
+
+    // The turn sign comes from TURN_LEFT_FORWARD_SIGN (common.h). If the heading runs
+    // away from the target, it is wrong for this robot: stop instead of spinning
+    if (nav->state == NAV_TURNING && !done &&
+        turn_wrong_way(nav->turn_start_heading, nav->target_heading, odom->heading)) {
+        stop_wheels(enc, out);
+        nav->state = NAV_IDLE;
+        out->events |= NAV_EVENT_WRONG_WAY;
+        return;
+    }
+
+    // A wheel that has made no progress for MOVE_STALL_LIMIT checks is pushing
+    // against something stall boost won't move
+    int stuck = 0;
+    for (int i = 0; i < 2; i++) {
+        stuck |= enc[i].has_target && enc[i].stall_count >= MOVE_STALL_LIMIT;
+    }
+
+    // Driving into the target bucket: a stall there is a position fix and the arrival.
+    // A drive that starts against the bucket never gets up to speed, the stall timeout
+    // is its contact
+    if (nav->state == NAV_DRIVING && nav->target_landmark >= 0 && !done &&
+        (contact_update(contact, enc[0].velocity, enc[1].velocity, now) || stuck)) {
+        const Landmark *lm = &landmarks[nav->target_landmark];
+        if (landmark_correct(odom, nav->target_landmark, &out->dx, &out->dy)) {
+            stop_wheels(enc, out);
+            nav->state = NAV_IDLE;
+            out->events |= NAV_EVENT_LANDMARK | NAV_EVENT_ARRIVED;
+            return;
+        }
+        out->events |= NAV_EVENT_REJECTED;
+        contact_reset(contact);
+
+        // Gated out, but stopped where the bumper meets the bucket: odometry is
+        // off sideways (or the gate is tight), still the arrival
+        double reach = hypot(lm->x - odom->x, lm->y - odom->y);
+        if (fabs(reach - LANDMARK_CONTACT_OFFSET_FT) < LANDMARK_ARRIVAL_SLACK_FT) {
+            stop_wheels(enc, out);
+            nav->state = NAV_IDLE;
+            out->events |= NAV_EVENT_ARRIVED;
+            return;
+        }
+        // Stalled somewhere the bucket can't be: stall compensation, then the timeout
+    }
+
+    if (stuck) {
+        stop_wheels(enc, out);
+        nav->state = NAV_IDLE;
+        out->events |= NAV_EVENT_STALLED;
+        return;
+    }
+
+    if (done) {
+        nav->state = NAV_GOTO; // Re-evaluate
+        nav->settle_since = -1; // Settle again before judging this move
+        out->events |= NAV_EVENT_MOVE_DONE;
+    }
+}
+
+NavState nav_step(NavigationController *nav, ContactDetector *contact, EncoderState enc[2],
+                  OdometryState *odom, const MotorParams *params, int min_pwm, int max_pwm,
+                  double now, NavStep *out) {
+    memset(out, 0, sizeof(*out));
+    switch (nav->state) {
+        case NAV_GOTO:
+            nav_plan(nav, contact, enc, odom, params, now, out);
+            break;
+        case NAV_TURNING:
+        case NAV_DRIVING:
+            nav_move(nav, contact, enc, odom, params, min_pwm, max_pwm, now, out);
+            break;
+        case NAV_IDLE:
+            break;
+    }
+    return nav->state;
+}
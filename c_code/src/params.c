@@ -0,0 +1,178 @@
+#include "../include/params.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+
+MotorParams motor_params;
+
+static const char *wheel_prefix[2] = {"left", "right"};
+
+// Keys within a section (file key is "<prefix>.<name>")
+typedef struct {
+    const char *name;
+    size_t offset;
+} ParamField;
+
+static const ParamField wheel_fields[] = {
+    {"deadband_ns", offsetof(WheelParams, deadband_ns)},
+    {"gain",        offsetof(WheelParams, gain)},
+    {"tau",         offsetof(WheelParams, tau)},
+    {"dead_time",   offsetof(WheelParams, dead_time)},
+    {"coast_decel", offsetof(WheelParams, coast_decel)},
+    {"vel_kp",      offsetof(WheelParams, vel_kp)},
+    {"vel_ki",      offsetof(WheelParams, vel_ki)},
+    {"max_speed",   offsetof(WheelParams, max_speed)},
+    {"ku",          offsetof(WheelParams, ku)},
+    {"pu",          offsetof(WheelParams, pu)},
+};
+
+static const ParamField esc_fields[] = {
+    {"mode",          offsetof(EscParams, mode)},
+    {"brake_ns",      offsetof(EscParams, brake_ns)},
+    {"brake_time",    offsetof(EscParams, brake_time)},
+    {"neutral_dwell", offsetof(EscParams, neutral_dwell)},
+    {"stop_speed",    offsetof(EscParams, stop_speed)},
+};
+
+#define NUM_FIELDS(fields) (sizeof(fields) / sizeof(fields[0]))
+
+// Sections of MotorParams, in file order
+typedef struct {
+    const char *prefix;
+    size_t base;                  // Offset of the section within MotorParams
+    const ParamField *fields;
+    size_t num_fields;
+} ParamSection;
+
+static const ParamSection sections[] = {
+    {"left",  offsetof(MotorParams, wheel[0]), wheel_fields, NUM_FIELDS(wheel_fields)},
+    {"right", offsetof(MotorParams, wheel[1]), wheel_fields, NUM_FIELDS(wheel_fields)},
+    {"esc",   offsetof(MotorParams, esc),      esc_fields,   NUM_FIELDS(esc_fields)},
+};
+#define NUM_SECTIONS NUM_FIELDS(sections)
+
+static double *field_ptr(MotorParams *p, const ParamSection *sec, const ParamField *field) {
+    return (double *)((char *)p + sec->base + field->offset);
+}
+
+static double field_value(const MotorParams *p, const ParamSection *sec, const ParamField *field) {
+    return *(const double *)((const char *)p + sec->base + field->offset);
+}
+
+void params_set_defaults(MotorParams *p) {
+    // Rough hand estimates, used until a model has been identified
+    for (int i = 0; i < 2; i++) {
+        p->wheel[i].deadband_ns = 30000.0;
+        p->wheel[i].gain = 40.0;
+        p->wheel[i].tau = 0.15;
+        p->wheel[i].dead_time = 0.02;
+        p->wheel[i].coast_decel = 20000.0;
+        p->wheel[i].vel_kp = 0.0;
+        p->wheel[i].vel_ki = 0.0;
+        p->wheel[i].max_speed = 0.0;
+        p->wheel[i].ku = 0.0;
+        p->wheel[i].pu = 0.0;
+    }
+
+    // Reverse directly, as before ESC shaping. Car ESCs that brake on the first
+    // reverse pulse set esc.mode = 2 in the parameter file; the timings below suit them
+    p->esc.mode = 0;
+    p->esc.brake_ns = 200000.0;
+    p->esc.brake_time = 0.3;
+    p->esc.neutral_dwell = 0.1;
+    p->esc.stop_speed = 300.0;
+    p->loaded = 0;
+}
+
+int params_load(MotorParams *p, const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+
+    char line[256];
+    int count = 0;
+    while (fgets(line, sizeof(line), f)) {
+        char key[64];
+        double value;
+
+        // Skip comments and blank lines
+        char *start = line + strspn(line, " \t");
+        if (*start == '#' || *start == '\n' || *start == '\0') continue;
+
+        if (sscanf(start, "%63[^= \t] = %lf", key, &value) != 2) {
+            fprintf(stderr, "WARNING: Bad line in %s: %s", path, line);
+            continue;
+        }
+
+        int matched = 0;
+        for (size_t s = 0; s < NUM_SECTIONS && !matched; s++) {
+            const ParamSection *sec = &sections[s];
+            size_t len = strlen(sec->prefix);
+            if (strncmp(key, sec->prefix, len) != 0 || key[len] != '.') continue;
+            for (size_t i = 0; i < sec->num_fields; i++) {
+                if (strcmp(key + len + 1, sec->fields[i].name) == 0) {
+                    *field_ptr(p, sec, &sec->fields[i]) = value;
+                    matched = 1;
+                    break;
+                }
+            }
+        }
+
+        if (matched) {
+            count++;
+        } else {
+            fprintf(stderr, "WARNING: Unknown parameter '%s' in %s\n", key, path);
+        }
+    }
+    fclose(f);
+
+    // An empty or unreadable file leaves the defaults in place
+    if (count > 0) p->loaded = 1;
+    return count;
+}
+
+int params_save(const MotorParams *p, const char *path) {
+    // Write to a temp file and rename so a crash never leaves a partial file
+    char temp_path[512];
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", path);
+
+    FILE *f = fopen(temp_path, "w");
+    if (!f) {
+        fprintf(stderr, "ERROR: Could not open parameter file %s\n", temp_path);
+        return -1;
+    }
+
+    fprintf(f, "# ASGC motor parameters (see c_code/include/params.h for units)\n");
+    for (size_t s = 0; s < NUM_SECTIONS; s++) {
+        const ParamSection *sec = &sections[s];
+        fprintf(f, "\n");
+        for (size_t i = 0; i < sec->num_fields; i++) {
+            fprintf(f, "%s.%s = %.6g\n", sec->prefix, sec->fields[i].name,
+                    field_value(p, sec, &sec->fields[i]));
+        }
+    }
+    fclose(f);
+
+    if (rename(temp_path, path) != 0) {
+        fprintf(stderr, "ERROR: Could not replace parameter file %s\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+void params_print(const MotorParams *p) {
+    for (int w = 0; w < 2; w++) {
+        printf("Params %-5s: deadband=%.0fns gain=%.2f tau=%.3fs dead_time=%.3fs coast_decel=%.0f\n",
+               wheel_prefix[w],
+               p->wheel[w].deadband_ns, p->wheel[w].gain, p->wheel[w].tau,
+               p->wheel[w].dead_time, p->wheel[w].coast_decel);
+        if (p->wheel[w].vel_kp > 0) {
+            printf("              vel_kp=%.5f vel_ki=%.5f max_speed=%.0f (Ku=%.5f Pu=%.3fs)\n",
+                   p->wheel[w].vel_kp, p->wheel[w].vel_ki, p->wheel[w].max_speed,
+                   p->wheel[w].ku, p->wheel[w].pu);
+        }
+    }
+    printf("Params esc  : mode=%d brake=%.0fns/%.2fs neutral_dwell=%.2fs stop_speed=%.0f\n",
+           (int)p->esc.mode, p->esc.brake_ns, p->esc.brake_time,
+           p->esc.neutral_dwell, p->esc.stop_speed);
+}
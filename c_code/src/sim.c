@@ -0,0 +1,610 @@
+#include "../include/sim.h"
+#include "../include/control.h"
+#include "../include/landmark.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// --- Per-lane random numbers (vectorizable: no cross-lane state) ---
+
+static inline uint32_t xorshift32(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static inline float uniform01(uint32_t *state) {
+    return (xorshift32(state) >> 8) * (1.0f / 16777216.0f);
+}
+
+// Irwin-Hall approximation of a standard normal (sum of 4 uniforms)
+static inline float gauss(uint32_t *state) {
+    float sum = uniform01(state) + uniform01(state) + uniform01(state) + uniform01(state);
+    return (sum - 2.0f) * 1.7320508f;
+}
+
+static void *lane_alloc(int padded, size_t elem) {
+    void *p = aligned_alloc(64, padded * elem);
+    if (p) memset(p, 0, padded * elem);
+    return p;
+}
+
+#define SIM_FLOAT_FIELDS(sim, X) \
+    X((sim)->wheel_pos[0]) X((sim)->wheel_pos[1]) X((sim)->wheel_vel[0]) X((sim)->wheel_vel[1]) \
+    X((sim)->esc_dir[0]) X((sim)->esc_dir[1]) X((sim)->esc_neutral[0]) X((sim)->esc_neutral[1]) \
+    X((sim)->gain[0]) X((sim)->gain[1]) X((sim)->deadband[0]) X((sim)->deadband[1]) \
+    X((sim)->inv_tau[0]) X((sim)->inv_tau[1]) X((sim)->feet_per_count[0]) X((sim)->feet_per_count[1]) \
+    X((sim)->x) X((sim)->y) X((sim)->cos_th) X((sim)->sin_th) X((sim)->gyro_bias) \
+    X((sim)->velocity[0]) X((sim)->velocity[1]) X((sim)->vel_time[0]) X((sim)->vel_time[1]) \
+    X((sim)->gyro) X((sim)->odom_x) X((sim)->odom_y) X((sim)->odom_h) X((sim)->odom_cos) X((sim)->odom_sin) X((sim)->odom_still) \
+    X((sim)->cmd_pulse[0]) X((sim)->cmd_pulse[1]) X((sim)->cmd_pending[0]) X((sim)->cmd_pending[1]) X((sim)->cmd_due)
+
+#define SIM_INT_FIELDS(sim, X) \
+    X((sim)->raw[0]) X((sim)->raw[1]) X((sim)->last_raw[0]) X((sim)->last_raw[1]) \
+    X((sim)->rotations[0]) X((sim)->rotations[1]) X((sim)->total[0]) X((sim)->total[1]) \
+    X((sim)->vel_pos[0]) X((sim)->vel_pos[1]) X((sim)->odom_last[0]) X((sim)->odom_last[1]) \
+    X((sim)->odom_anchor[0]) X((sim)->odom_anchor[1])
+
+int sim_init(SimPlant *sim, int lanes, const MotorParams *params, const SimNoise *noise, uint32_t seed) {
+    memset(sim, 0, sizeof(*sim));
+    sim->lanes = lanes;
+    sim->padded = (lanes + SIM_LANE_ALIGN - 1) / SIM_LANE_ALIGN * SIM_LANE_ALIGN;
+    int n = sim->padded;
+    int failed = 0;
+
+#define ALLOC_FLOAT(field) if (!((field) = lane_alloc(n, sizeof(float)))) failed = 1;
+#define ALLOC_INT(field) if (!((field) = lane_alloc(n, sizeof(int32_t)))) failed = 1;
+    SIM_FLOAT_FIELDS(sim, ALLOC_FLOAT)
+    SIM_INT_FIELDS(sim, ALLOC_INT)
+#undef ALLOC_FLOAT
+#undef ALLOC_INT
+    for (int w = 0; w < 2; w++) {
+        if (!(sim->cmd_hist[w] = lane_alloc(n * SIM_DELAY_STEPS, sizeof(float)))) failed = 1;
+    }
+    if (!(sim->rng = lane_alloc(n, sizeof(uint32_t)))) failed = 1;
+    if (!(sim->fault_rng = lane_alloc(n, sizeof(uint32_t)))) failed = 1;
+    if (failed) {
+        fprintf(stderr, "ERROR: Failed to allocate simulator for %d robots\n", lanes);
+        sim_free(sim);
+        return -1;
+    }
+
+    for (int w = 0; w < 2; w++) {
+        const WheelParams *wp = &params->wheel[w];
+        int delay = (int)lround(wp->dead_time / SIM_DT);
+        if (delay < 0) delay = 0;
+        if (delay > SIM_DELAY_STEPS - 1) delay = SIM_DELAY_STEPS - 1;
+        sim->delay_steps[w] = delay;
+        sim->coast_decel[w] = (float)wp->coast_decel;
+    }
+    sim->esc_mode = (int)params->esc.mode;
+    sim->esc_dwell = (float)params->esc.neutral_dwell;
+    sim->gyro_noise = noise->gyro_noise;
+    sim->encoder_noise = noise->encoder_noise;
+
+    // Draw each robot's plant from the identified model plus spread
+    uint32_t init_rng = seed ? seed : 1;
+    for (int i = 0; i < n; i++) {
+        for (int w = 0; w < 2; w++) {
+            const WheelParams *wp = &params->wheel[w];
+            sim->gain[w][i] = (float)(wp->gain * (1.0 + noise->gain * gauss(&init_rng)));
+            sim->deadband[w][i] = (float)(wp->deadband_ns * (1.0 + noise->deadband * gauss(&init_rng)));
+            double tau = wp->tau * (1.0 + noise->tau * gauss(&init_rng));
+            sim->inv_tau[w][i] = (float)(1.0 / (tau > 0.01 ? tau : 0.01));
+            double diameter = WHEEL_DIAMETER_INCHES * (1.0 + noise->wheel_diameter * gauss(&init_rng));
+            sim->feet_per_count[w][i] = (float)(M_PI * diameter / COUNTS_PER_REV / INCHES_PER_FOOT);
+        }
+        sim->gyro_bias[i] = noise->gyro_bias * gauss(&init_rng);
+        sim->rng[i] = xorshift32(&init_rng) | 1;
+    }
+
+    // Separate stream for injected faults, so plant noise is the same with and without them
+    uint32_t fault_rng = (seed ^ 0x9e3779b9u) | 1;
+    for (int i = 0; i < n; i++) {
+        sim->fault_rng[i] = xorshift32(&fault_rng) | 1;
+    }
+    return 0;
+}
+
+int sim_set_latency(SimPlant *sim, const SimLatency *latency) {
+    int actuator_steps = (int)lroundf(latency->actuator_delay / SIM_DT);
+    int sensor_steps = (int)lroundf(latency->sensor_delay / SIM_DT);
+    int jitter_steps = (int)lroundf(latency->sensor_jitter / SIM_DT);
+
+    for (int w = 0; w < 2; w++) {
+        if (actuator_steps < 0 || sim->delay_steps[w] + actuator_steps > SIM_DELAY_STEPS - 1) {
+            fprintf(stderr, "ERROR: Actuator delay must be 0-%.0f ms\n",
+                    (SIM_DELAY_STEPS - 1 - sim->delay_steps[w]) * SIM_DT * 1000.0f);
+            return -1;
+        }
+    }
+    if (sensor_steps < 0 || jitter_steps < 0 || sensor_steps + jitter_steps > SIM_LATENCY_STEPS - 1) {
+        fprintf(stderr, "ERROR: Sensor delay + jitter must be 0-%.0f ms\n",
+                (SIM_LATENCY_STEPS - 1) * SIM_DT * 1000.0f);
+        return -1;
+    }
+
+    sim->latency = *latency;
+    for (int w = 0; w < 2; w++) {
+        sim->delay_steps[w] += actuator_steps;
+    }
+    sim->sensor_steps = sensor_steps;
+    sim->sensor_jitter_steps = jitter_steps;
+
+    // Only keep sensor history when a read can be older than the current sample
+    if (sensor_steps + jitter_steps > 0 && !sim->hist_total[0]) {
+        int size = sim->padded * SIM_LATENCY_STEPS;
+        int failed = 0;
+        for (int w = 0; w < 2; w++) {
+            if (!(sim->hist_total[w] = lane_alloc(size, sizeof(int32_t)))) failed = 1;
+            if (!(sim->hist_velocity[w] = lane_alloc(size, sizeof(float)))) failed = 1;
+        }
+        for (int k = 0; k < 3; k++) {
+            if (!(sim->hist_odom[k] = lane_alloc(size, sizeof(float)))) failed = 1;
+        }
+        if (failed) {
+            fprintf(stderr, "ERROR: Failed to allocate sensor history for %d robots\n", sim->lanes);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void sim_free(SimPlant *sim) {
+#define FREE_FIELD(field) free(field); (field) = NULL;
+    SIM_FLOAT_FIELDS(sim, FREE_FIELD)
+    SIM_INT_FIELDS(sim, FREE_FIELD)
+#undef FREE_FIELD
+    for (int w = 0; w < 2; w++) {
+        free(sim->cmd_hist[w]);
+        sim->cmd_hist[w] = NULL;
+    }
+    for (int w = 0; w < 2; w++) {
+        free(sim->hist_total[w]);
+        free(sim->hist_velocity[w]);
+        sim->hist_total[w] = NULL;
+        sim->hist_velocity[w] = NULL;
+    }
+    for (int k = 0; k < 3; k++) {
+        free(sim->hist_odom[k]);
+        sim->hist_odom[k] = NULL;
+    }
+    free(sim->rng);
+    free(sim->fault_rng);
+    sim->rng = NULL;
+    sim->fault_rng = NULL;
+}
+
+// Record this step's sensor state for delayed reads
+static void record_history(SimPlant *sim) {
+    const int n = sim->padded;
+    const size_t row = (size_t)(sim->step % SIM_LATENCY_STEPS) * n;
+    for (int w = 0; w < 2; w++) {
+        memcpy(sim->hist_total[w] + row, sim->total[w], sizeof(int32_t) * n);
+        memcpy(sim->hist_velocity[w] + row, sim->velocity[w], sizeof(float) * n);
+    }
+    memcpy(sim->hist_odom[0] + row, sim->odom_x, sizeof(float) * n);
+    memcpy(sim->hist_odom[1] + row, sim->odom_y, sizeof(float) * n);
+    memcpy(sim->hist_odom[2] + row, sim->odom_h, sizeof(float) * n);
+}
+
+void sim_reset_pose(SimPlant *sim, double x, double y, double heading) {
+    int n = sim->padded;
+    double heading_rad = heading * M_PI / 180.0;
+    sim->time = 0;
+    sim->step = 0;
+
+    for (int i = 0; i < n; i++) {
+        sim->x[i] = sim->odom_x[i] = (float)x;
+        sim->y[i] = sim->odom_y[i] = (float)y;
+        sim->cos_th[i] = sim->odom_cos[i] = (float)cos(heading_rad);
+        sim->sin_th[i] = sim->odom_sin[i] = (float)sin(heading_rad);
+        sim->odom_h[i] = (float)heading;
+        sim->gyro[i] = 0;
+        sim->odom_still[i] = ODOM_MOTION_HOLD_SEC;
+
+        for (int w = 0; w < 2; w++) {
+            // Magnets sit at an arbitrary angle on each wheel
+            float pos = uniform01(&sim->rng[i]) * (COUNTS_PER_REV - 1);
+            sim->wheel_pos[w][i] = pos;
+            sim->wheel_vel[w][i] = 0;
+            sim->esc_dir[w][i] = 0;
+            sim->esc_neutral[w][i] = 0;
+            sim->cmd_pulse[w][i] = 0;
+            sim->cmd_pending[w][i] = 0;
+            sim->raw[w][i] = sim->last_raw[w][i] = (int32_t)pos;
+            sim->rotations[w][i] = 0;
+            sim->total[w][i] = (int32_t)pos;
+            sim->velocity[w][i] = 0;
+            sim->vel_time[w][i] = 0;
+            sim->vel_pos[w][i] = (int32_t)pos;
+            sim->odom_last[w][i] = (int32_t)pos;
+            sim->odom_anchor[w][i] = (int32_t)pos;
+        }
+        sim->cmd_due[i] = -1.0f;
+    }
+    for (int w = 0; w < 2; w++) {
+        memset(sim->cmd_hist[w], 0, sizeof(float) * n * SIM_DELAY_STEPS);
+    }
+
+    // Delayed reads before the first steps see the starting pose
+    if (sim->hist_total[0]) {
+        for (int k = 0; k < SIM_LATENCY_STEPS; k++) {
+            sim->step = k;
+            record_history(sim);
+        }
+        sim->step = 0;
+    }
+}
+
+// --- Kernels: one loop over lanes each, branch-free bodies ---
+
+// Jittered commands land at the ESC input once their delay has passed
+static void kernel_actuator(SimPlant *sim) {
+    const int n = sim->padded;
+    const float now = sim->time;
+
+    float *restrict due = sim->cmd_due;
+    float *restrict cmd_l = sim->cmd_pulse[0];
+    float *restrict cmd_r = sim->cmd_pulse[1];
+    const float *restrict pend_l = sim->cmd_pending[0];
+    const float *restrict pend_r = sim->cmd_pending[1];
+
+    #pragma omp simd
+    for (int i = 0; i < n; i++) {
+        float land = ((due[i] >= 0.0f) ? 1.0f : 0.0f) * ((due[i] <= now) ? 1.0f : 0.0f);
+        cmd_l[i] += (pend_l[i] - cmd_l[i]) * land;
+        cmd_r[i] += (pend_r[i] - cmd_r[i]) * land;
+        due[i] += (-1.0f - due[i]) * land;
+    }
+}
+
+// ESC latch and wheel dynamics for one wheel
+static void kernel_wheel(SimPlant *sim, int w) {
+    const int n = sim->padded;
+    const float dt = SIM_DT;
+    const float coast = sim->coast_decel[w] * dt;
+    const float brake = coast * SIM_BRAKE_DECEL_SCALE;
+    const float dwell = sim->esc_dwell;
+    const int mode = sim->esc_mode;
+
+    float *hist = sim->cmd_hist[w];
+    float *restrict cmd = sim->cmd_pulse[w];
+    float *restrict pos = sim->wheel_pos[w];
+    float *restrict vel = sim->wheel_vel[w];
+    float *restrict latched = sim->esc_dir[w];
+    float *restrict neutral = sim->esc_neutral[w];
+    const float *restrict gain = sim->gain[w];
+    const float *restrict deadband = sim->deadband[w];
+    const float *restrict inv_tau = sim->inv_tau[w];
+
+    // Dead time: the plant sees the command from delay_steps ago (same row when there is none)
+    float *write_row = hist + (sim->step % SIM_DELAY_STEPS) * n;
+    const float *read_row = hist + ((sim->step + SIM_DELAY_STEPS - sim->delay_steps[w]) % SIM_DELAY_STEPS) * n;
+
+    #pragma omp simd
+    for (int i = 0; i < n; i++) {
+        write_row[i] = cmd[i];
+    }
+
+    // Mode switches as 0/1 factors, so the lane loop is straight-line arithmetic
+    const float latches = (mode != ESC_MODE_DIRECT) ? 1.0f : 0.0f;
+    const float brakes = (mode == ESC_MODE_BRAKE) ? 1.0f : 0.0f;
+
+    #pragma omp simd
+    for (int i = 0; i < n; i++) {
+        float u = read_row[i];
+        float fwd = (u > 10000.0f) ? 1.0f : 0.0f;
+        float rev = (u < -10000.0f) ? 1.0f : 0.0f;
+        float dir = fwd - rev;
+        float active = fwd + rev;
+        float v = vel[i];
+
+        // ESC latch: releases after a neutral dwell, reverse pulse brakes while latched
+        float neutral_time = (neutral[i] + dt) * (1.0f - active);
+        float released = (neutral_time >= dwell) ? 1.0f : 0.0f;
+        float dir_latched = latched[i] * (1.0f - released);
+        float against = ((dir * dir_latched < 0.0f) ? 1.0f : 0.0f) * latches;
+        float engage = active * (1.0f - against);
+        dir_latched += (dir - dir_latched) * engage;
+
+        // Driven speed: gain beyond the deadband, first-order response
+        float excess = fabsf(u) - deadband[i];
+        float above = (excess > 0.0f) ? 1.0f : 0.0f;
+        float target = dir * gain[i] * excess * above * 0.001f;
+        float v_driven = v + (target - v) * (dt * inv_tau[i]);
+
+        // Coasting (deadband or neutral) and braking decelerate towards zero
+        float decel = coast + (brake - coast) * against * brakes;
+        float mag = fabsf(v) - decel;
+        mag *= (mag > 0.0f) ? 1.0f : 0.0f;
+        float v_free = copysignf(mag, v);
+
+        v = v_free + (v_driven - v_free) * (engage * above);
+        vel[i] = v;
+        pos[i] += v * dt;
+        latched[i] = dir_latched;
+        neutral[i] = neutral_time;
+    }
+}
+
+// True pose from wheel travel, and the gyro reading
+static void kernel_body(SimPlant *sim) {
+    const int n = sim->padded;
+    const float dt = SIM_DT;
+    const float inv_track = 1.0f / (WHEELBASE_INCHES / INCHES_PER_FOOT);
+    const float rad_to_deg = 180.0f / (float)M_PI;
+    const float gyro_noise = sim->gyro_noise;
+    const float contact2 = (float)(LANDMARK_CONTACT_OFFSET_FT * LANDMARK_CONTACT_OFFSET_FT);
+    float bucket_x[LANDMARK_COUNT], bucket_y[LANDMARK_COUNT];
+    for (int k = 0; k < LANDMARK_COUNT; k++) {
+        bucket_x[k] = (float)landmarks[k].x;
+        bucket_y[k] = (float)landmarks[k].y;
+    }
+
+    float *restrict vl = sim->wheel_vel[0];
+    float *restrict vr = sim->wheel_vel[1];
+    float *restrict pl = sim->wheel_pos[0];
+    float *restrict pr = sim->wheel_pos[1];
+    const float *restrict fl = sim->feet_per_count[0];
+    const float *restrict fr = sim->feet_per_count[1];
+    const float *restrict bias = sim->gyro_bias;
+    float *restrict x = sim->x;
+    float *restrict y = sim->y;
+    float *restrict c = sim->cos_th;
+    float *restrict s = sim->sin_th;
+    float *restrict gyro = sim->gyro;
+    uint32_t *restrict rng = sim->rng;
+
+    #pragma omp simd
+    for (int i = 0; i < n; i++) {
+        // Bumper against a bucket (center within the contact offset, and within 45 deg
+        // of the direction of travel): a wheel pushing towards it stalls. Turning in
+        // place (wheels opposite) slides the bumper along it, and a bucket further to
+        // the side is scraped past
+        float dir = (vl[i] + vr[i] >= 0.0f) ? 1.0f : -1.0f;
+        float blocked = 0.0f;
+        for (int k = 0; k < LANDMARK_COUNT; k++) {
+            float bx = bucket_x[k] - x[i];
+            float by = bucket_y[k] - y[i];
+            float dist2 = bx * bx + by * by;
+            float ahead = dir * (c[i] * bx + s[i] * by);
+            float touching = (dist2 < contact2) ? 1.0f : 0.0f;
+            float toward = ((ahead > 0.0f) ? 1.0f : 0.0f) * ((ahead * ahead > 0.5f * dist2) ? 1.0f : 0.0f);
+            blocked += (1.0f - blocked) * touching * toward;
+        }
+        blocked *= (vl[i] * vr[i] >= 0.0f) ? 1.0f : 0.0f;
+        float stall_l = blocked * ((vl[i] * dir > 0.0f) ? vl[i] : 0.0f);
+        float stall_r = blocked * ((vr[i] * dir > 0.0f) ? vr[i] : 0.0f);
+        vl[i] -= stall_l;
+        vr[i] -= stall_r;
+        pl[i] -= stall_l * dt; // Take back this step's kernel_wheel travel
+        pr[i] -= stall_r * dt;
+
+        float left = vl[i] * fl[i];
+        float right = vr[i] * fr[i];
+        float v = 0.5f * (left + right);
+        // Heading convention of the controller (TURN_LEFT_FORWARD_SIGN)
+        float omega = TURN_LEFT_FORWARD_SIGN * (left - right) * inv_track;
+
+        x[i] += v * dt * c[i];
+        y[i] += v * dt * s[i];
+
+        // Rotate the heading vector by a small angle, then renormalize
+        float a = omega * dt;
+        float ca = 1.0f - 0.5f * a * a;
+        float sa = a - a * a * a * (1.0f / 6.0f);
+        float cn = c[i] * ca - s[i] * sa;
+        float sn = s[i] * ca + c[i] * sa;
+        float r = 1.0f / sqrtf(cn * cn + sn * sn);
+        c[i] = cn * r;
+        s[i] = sn * r;
+
+        // MPU6050: bias + white noise, quantized to one LSB
+        float g = omega * rad_to_deg + bias[i] + gyro_noise * gauss(&rng[i]);
+        float lsb = g * (1.0f / SIM_GYRO_LSB_DPS);
+        int q = (int)(lsb + copysignf(0.5f, lsb));
+        gyro[i] = q * SIM_GYRO_LSB_DPS;
+    }
+}
+
+// AS5600 reading, wrap tracking (update_encoder_rotation) and velocity (update_encoder_velocity)
+static void kernel_encoder(SimPlant *sim, int w) {
+    const int n = sim->padded;
+    const float now = sim->time;
+    const float noise = sim->encoder_noise;
+
+    const float *restrict pos = sim->wheel_pos[w];
+    int32_t *restrict raw = sim->raw[w];
+    int32_t *restrict last = sim->last_raw[w];
+    int32_t *restrict rot = sim->rotations[w];
+    int32_t *restrict total = sim->total[w];
+    float *restrict vel = sim->velocity[w];
+    float *restrict vel_time = sim->vel_time[w];
+    int32_t *restrict vel_pos = sim->vel_pos[w];
+    uint32_t *restrict rng = sim->rng;
+
+    #pragma omp simd
+    for (int i = 0; i < n; i++) {
+        float p = pos[i] + noise * gauss(&rng[i]);
+
+        // Wrap to 0-4095 (floor without libm so the loop vectorizes)
+        float turns = p * (1.0f / COUNTS_PER_REV);
+        int whole = (int)turns;
+        whole -= (turns < (float)whole);
+        int angle = (int)(p - (float)whole * COUNTS_PER_REV);
+        angle = angle < 0 ? 0 : (angle > COUNTS_PER_REV - 1 ? COUNTS_PER_REV - 1 : angle);
+
+        int jump = angle - last[i];
+        rot[i] += (jump < -COUNTS_PER_REV / 2) - (jump > COUNTS_PER_REV / 2);
+        last[i] = angle;
+        raw[i] = angle;
+        int32_t t = COUNTS_PER_REV * rot[i] + angle;
+        total[i] = t;
+
+        // Velocity window: update (factor 1) or keep (factor 0)
+        float dt = now - vel_time[i];
+        int update = dt >= (float)VELOCITY_WINDOW_SEC;
+        float raw_v = (float)(t - vel_pos[i]) / (dt + (float)(1 - update));
+        vel[i] += (float)VELOCITY_FILTER_ALPHA * (raw_v - vel[i]) * (float)update;
+        vel_time[i] += (now - vel_time[i]) * (float)update;
+        vel_pos[i] += (t - vel_pos[i]) * update;
+    }
+}
+
+// Dead reckoning exactly as update_odometry(), with the heading kept as a unit vector
+static void kernel_odometry(SimPlant *sim) {
+    const int n = sim->padded;
+    const float dt = SIM_DT;
+    const float feet_per_count = (float)(1.0 / COUNTS_PER_FOOT);
+    const float deg_to_rad = (float)M_PI / 180.0f;
+
+    const int32_t *restrict tl = sim->total[0];
+    const int32_t *restrict tr = sim->total[1];
+    int32_t *restrict ll = sim->odom_last[0];
+    int32_t *restrict lr = sim->odom_last[1];
+    int32_t *restrict al = sim->odom_anchor[0];
+    int32_t *restrict ar = sim->odom_anchor[1];
+    float *restrict still = sim->odom_still;
+    const float *restrict gyro = sim->gyro;
+    float *restrict x = sim->odom_x;
+    float *restrict y = sim->odom_y;
+    float *restrict h = sim->odom_h;
+    float *restrict c = sim->odom_cos;
+    float *restrict s = sim->odom_sin;
+
+    #pragma omp simd
+    for (int i = 0; i < n; i++) {
+        float dist_left = (float)(tl[i] - ll[i]) * feet_per_count;
+        float dist_right = (float)(tr[i] - lr[i]) * feet_per_count;
+        float center = 0.5f * (dist_left + dist_right);
+        ll[i] = tl[i];
+        lr[i] = tr[i];
+
+        float rate = gyro[i] * ((fabsf(gyro[i]) < 0.25f) ? 0.0f : 1.0f);
+        int32_t moved = (abs(tl[i] - al[i]) > ODOM_MOTION_COUNTS) | (abs(tr[i] - ar[i]) > ODOM_MOTION_COUNTS);
+        al[i] = moved ? tl[i] : al[i];
+        ar[i] = moved ? tr[i] : ar[i];
+        still[i] = moved ? 0.0f : still[i] + dt;
+        float moving = (still[i] < (float)ODOM_MOTION_HOLD_SEC) ? 1.0f : 0.0f;
+        float delta = rate * dt * moving;
+
+        // Position along the average heading of the interval
+        float half = 0.5f * delta * deg_to_rad;
+        float ch = 1.0f - 0.5f * half * half;
+        float sh = half - half * half * half * (1.0f / 6.0f);
+        float ca = c[i] * ch - s[i] * sh;
+        float sa = s[i] * ch + c[i] * sh;
+        x[i] += center * ca;
+        y[i] += center * sa;
+
+        // Full step rotation for the new heading
+        float cn = ca * ch - sa * sh;
+        float sn = sa * ch + ca * sh;
+        float r = 1.0f / sqrtf(cn * cn + sn * sn);
+        c[i] = cn * r;
+        s[i] = sn * r;
+
+        float heading = h[i] + delta;
+        heading -= (heading >= 360.0f) ? 360.0f : 0.0f;
+        heading += (heading < 0.0f) ? 360.0f : 0.0f;
+        h[i] = heading;
+    }
+}
+
+void sim_step(SimPlant *sim) {
+    if (sim->latency.actuator_jitter > 0) kernel_actuator(sim);
+    kernel_wheel(sim, 0);
+    kernel_wheel(sim, 1);
+    kernel_body(sim);
+    sim->step++;
+    sim->time = sim->step * SIM_DT;
+    kernel_encoder(sim, 0);
+    kernel_encoder(sim, 1);
+    kernel_odometry(sim);
+    if (sim->hist_total[0]) record_history(sim);
+}
+
+static void encoder_from_total(EncoderState *enc, int32_t total, float velocity) {
+    int32_t angle = ((total % COUNTS_PER_REV) + COUNTS_PER_REV) % COUNTS_PER_REV;
+    enc->current_raw_angle = (int16_t)angle;
+    enc->last_raw_angle = (int16_t)angle;
+    enc->rotation_count = (total - angle) / COUNTS_PER_REV;
+    enc->total_counts = total;
+    enc->start_raw_angle = 0;
+    enc->velocity = velocity;
+}
+
+int sim_read_sensors(SimPlant *sim, int lane, EncoderState enc[2], OdometryState *odom) {
+    const SimLatency *lat = &sim->latency;
+    uint32_t *rng = &sim->fault_rng[lane];
+    double heading = odom->heading;
+
+    if (lat->sensor_drop > 0 && uniform01(rng) < lat->sensor_drop) return 0;
+
+    if (sim->hist_total[0]) {
+        int age = sim->sensor_steps;
+        if (sim->sensor_jitter_steps > 0) {
+            age += (int)(uniform01(rng) * (sim->sensor_jitter_steps + 1));
+        }
+        size_t at = (size_t)((sim->step - age + SIM_LATENCY_STEPS) % SIM_LATENCY_STEPS) * sim->padded + lane;
+        for (int w = 0; w < 2; w++) {
+            encoder_from_total(&enc[w], sim->hist_total[w][at], sim->hist_velocity[w][at]);
+        }
+        odom->x = sim->hist_odom[0][at];
+        odom->y = sim->hist_odom[1][at];
+        odom->heading = sim->hist_odom[2][at];
+    } else {
+        for (int w = 0; w < 2; w++) {
+            encoder_from_total(&enc[w], sim->total[w][lane], sim->velocity[w][lane]);
+        }
+        odom->x = sim->odom_x[lane];
+        odom->y = sim->odom_y[lane];
+        odom->heading = sim->odom_h[lane];
+    }
+    // Uncertainty of the pose read, grown like update_odometry() does
+    double moved = 0.5 * ((enc[0].total_counts - odom->last_left_total) +
+                          (enc[1].total_counts - odom->last_right_total)) / COUNTS_PER_FOOT;
+    double turned = odom->heading - heading;
+    while (turned > 180) turned -= 360;
+    while (turned < -180) turned += 360;
+    odometry_grow_variance(odom, moved, turned);
+
+    odom->last_left_total = enc[0].total_counts;
+    odom->last_right_total = enc[1].total_counts;
+    return 1;
+}
+
+void sim_correct_odometry(SimPlant *sim, int lane, double dx, double dy) {
+    sim->odom_x[lane] += (float)dx;
+    sim->odom_y[lane] += (float)dy;
+    if (!sim->hist_total[0]) return;
+    for (int k = 0; k < SIM_LATENCY_STEPS; k++) {
+        size_t at = (size_t)k * sim->padded + lane;
+        sim->hist_odom[0][at] += (float)dx;
+        sim->hist_odom[1][at] += (float)dy;
+    }
+}
+
+void sim_write_command(SimPlant *sim, int lane, float left, float right) {
+    const SimLatency *lat = &sim->latency;
+    uint32_t *rng = &sim->fault_rng[lane];
+
+    if (lat->actuator_drop > 0 && uniform01(rng) < lat->actuator_drop) return;
+
+    if (lat->actuator_jitter > 0) {
+        // A late write carries whatever command is newest when it lands
+        sim->cmd_pending[0][lane] = left;
+        sim->cmd_pending[1][lane] = right;
+        if (sim->cmd_due[lane] < 0) {
+            sim->cmd_due[lane] = sim->time + uniform01(rng) * lat->actuator_jitter;
+        }
+        return;
+    }
+    sim->cmd_pulse[0][lane] = left;
+    sim->cmd_pulse[1][lane] = right;
+}
@@ -0,0 +1,66 @@
+#include "../include/telemetry.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static TelemetryRingHeader *ring_header = NULL;
+static LogEntry *ring_entries = NULL;
+static size_t ring_size = 0;
+
+int telemetry_ring_open(void) {
+    ring_size = sizeof(TelemetryRingHeader) + sizeof(LogEntry) * TELEMETRY_RING_CAPACITY;
+
+    // No O_TRUNC: a live reader touching a zero-length mapping would get SIGBUS
+    int fd = open(TELEMETRY_RING_PATH, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        perror("Failed to create telemetry ring");
+        return -1;
+    }
+    // Readers run as a normal user, controller runs under sudo
+    fchmod(fd, 0644);
+
+    if (ftruncate(fd, ring_size) < 0) {
+        perror("Failed to size telemetry ring");
+        close(fd);
+        return -1;
+    }
+
+    void *mem = mmap(NULL, ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd); // Mapping stays valid
+    if (mem == MAP_FAILED) {
+        perror("Failed to map telemetry ring");
+        return -1;
+    }
+
+    ring_header = (TelemetryRingHeader *)mem;
+    ring_entries = (LogEntry *)((char *)mem + sizeof(TelemetryRingHeader));
+
+    memset(ring_header, 0, sizeof(TelemetryRingHeader));
+    ring_header->entry_size = sizeof(LogEntry);
+    ring_header->capacity = TELEMETRY_RING_CAPACITY;
+    ring_header->version = TELEMETRY_RING_VERSION;
+    // Magic last, so readers never see a half-initialized header as valid
+    __atomic_store_n(&ring_header->magic, TELEMETRY_RING_MAGIC, __ATOMIC_RELEASE);
+
+    printf("Telemetry ring at %s (%d entries)\n", TELEMETRY_RING_PATH, TELEMETRY_RING_CAPACITY);
+    return 0;
+}
+
+void telemetry_ring_push(const LogEntry *entry) {
+    if (!ring_header) return;
+
+    // Single writer (control thread): fill the slot, then publish the index
+    uint64_t index = ring_header->write_index;
+    ring_entries[index % TELEMETRY_RING_CAPACITY] = *entry;
+    __atomic_store_n(&ring_header->write_index, index + 1, __ATOMIC_RELEASE);
+}
+
+void telemetry_ring_close(void) {
+    if (!ring_header) return;
+    munmap(ring_header, ring_size);
+    ring_header = NULL;
+    ring_entries = NULL;
+}
@@ -0,0 +1,46 @@
+#include "../include/trace.h"
+#include "../include/common.h"
+#include <stdio.h>
+#include <stdarg.h>
+#include <sys/stat.h>
+
+static FILE *trace_file = NULL;
+
+int trace_open(const char *path) {
+    trace_file = fopen(path, "w");
+    if (!trace_file) {
+        perror("Failed to open trace file");
+        return -1;
+    }
+    // Controller runs under sudo, the merge tool runs as a normal user
+    chmod(path, 0644);
+    setvbuf(trace_file, NULL, _IOLBF, 0);
+    printf("Tracing to %s\n", path);
+    return 0;
+}
+
+void trace_close(void) {
+    if (!trace_file) return;
+    fclose(trace_file);
+    trace_file = NULL;
+}
+
+int trace_enabled(void) {
+    return trace_file != NULL;
+}
+
+void trace_event(const char *event, const char *fmt, ...) {
+    if (!trace_file) return;
+
+    // Timestamp first so the event is placed where it happened, not where it was formatted
+    double now = get_time_sec();
+
+    char detail[256];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(detail, sizeof(detail), fmt, args);
+    va_end(args);
+
+    // One fprintf per line: stdio locking keeps lines from different threads whole
+    fprintf(trace_file, "%.6f\tcontroller\t%s\t%s\n", now, event, detail);
+}
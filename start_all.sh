@@ -112,5 +112,11 @@ fi
 
 # 6. Start Web Server
 echo "Starting Web Server..."
-# Note: The server needs to be run with python3, and it will internally use sudo for the motor process
-python3 web_server.py
+# Gunicorn serves HTTPS and WebSockets (settings in gunicorn.conf.py).
+# The app starts the motor process itself, internally using sudo.
+# For development, python3 web_server.py runs Flask's built-in server instead.
+if ! python3 -c "import gunicorn" 2>/dev/null; then
+    echo "Installing gunicorn..."
+    pip install -r requirements.txt
+fi
+exec gunicorn -c gunicorn.conf.py web_server:app
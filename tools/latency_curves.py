@@ -0,0 +1,103 @@
+#!/usr/bin/env python3
+"""
+Latency Tolerance Curves
+
+Plots the CSV written by `asgc_batch_sim --sweep ... --csv FILE`: one panel
+per metric against the swept latency setting. Several files (e.g. the same
+sweep with two parameter files) are overlaid for comparison.
+
+Usage:
+    cd c_code && ./asgc_batch_sim --robots 1024 --sweep sensor-delay=0,5,10,20,40 --csv sensor.csv
+    python3 tools/latency_curves.py c_code/sensor.csv
+    python3 tools/latency_curves.py before.csv after.csv --save curves.png
+"""
+
+import argparse
+import csv
+import sys
+
+# Column -> (panel title, reference line or None)
+METRICS = {
+    'completed_pct':          ('Robots finishing the route (%)', None),
+    'course_mean_s':          ('Course time, mean (s)', None),
+    'final_mean_ft':          ('Final position error, mean (ft)', None),
+    'moves_per_leg':          ('Turn/drive moves per leg', None),
+    'turn_reversals_per_leg': ('GOTO turn reversals per leg', None),
+    'overshoot_pct':          ('Moves past STOP_THRESHOLD (%)', None),
+    'overshoot_mean_counts':  ('Peak overshoot, mean (counts)', 200),  # STOP_THRESHOLD
+}
+
+
+def load_curve(path):
+    """Returns (x column name, {column: [values]})"""
+    with open(path, newline='') as f:
+        reader = csv.DictReader(f)
+        x_name = reader.fieldnames[0]
+        columns = {name: [] for name in reader.fieldnames}
+        for row in reader:
+            for name in reader.fieldnames:
+                columns[name].append(float(row[name]))
+    return x_name, columns
+
+
+def print_curve(path, x_name, columns):
+    print(f"{path} ({x_name})")
+    names = [x_name] + [m for m in METRICS if m in columns]
+    print('  '.join(f"{n[:12]:>12}" for n in names))
+    for i in range(len(columns[x_name])):
+        print('  '.join(f"{columns[n][i]:12.3f}" for n in names))
+    print()
+
+
+def plot_curves(curves, save=None):
+    import matplotlib.pyplot as plt
+
+    metrics = [m for m in METRICS if any(m in c for _, _, c in curves)]
+    cols = 2
+    rows = (len(metrics) + cols - 1) // cols
+    fig, axes = plt.subplots(rows, cols, figsize=(12, 3 * rows), squeeze=False)
+
+    for ax, metric in zip(axes.flat, metrics):
+        title, reference = METRICS[metric]
+        for path, x_name, columns in curves:
+            if metric in columns:
+                ax.plot(columns[x_name], columns[metric], 'o-', label=path)
+        if reference is not None:
+            ax.axhline(reference, color='red', linestyle='--', linewidth=1)
+        ax.set_title(title, fontsize=10)
+        ax.set_xlabel(curves[0][1])
+        ax.grid(True, alpha=0.3)
+    for ax in list(axes.flat)[len(metrics):]:
+        ax.axis('off')
+
+    if len(curves) > 1:
+        axes.flat[0].legend(fontsize=8)
+    fig.suptitle('ASGC Controller Latency Tolerance')
+    plt.tight_layout()
+    if save:
+        plt.savefig(save, dpi=120)
+        print(f"Saved {save}")
+    else:
+        plt.show()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Plot asgc_batch_sim latency sweep curves")
+    parser.add_argument('files', nargs='+', help="CSV files from asgc_batch_sim --csv")
+    parser.add_argument('--save', help="Write the figure to a file instead of showing it")
+    parser.add_argument('--no-plot', action='store_true', help="Only print the tables")
+    args = parser.parse_args()
+
+    curves = []
+    for path in args.files:
+        x_name, columns = load_curve(path)
+        curves.append((path, x_name, columns))
+        print_curve(path, x_name, columns)
+
+    if not args.no_plot:
+        plot_curves(curves, args.save)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,222 @@
+#!/usr/bin/env python3
+"""
+Web Server Load Test
+
+Simulates several browsers against a running server. Each one holds the
+joystick WebSocket open and sends joystick messages at the joystick page's
+rate, while polling /api/navigation/status at 30 Hz like the course view.
+
+Only neutral pulses (1.5 ms) are sent, so the wheels do not turn. Keep the
+robot lifted anyway.
+
+Reports:
+- joystick round-trip latency (send -> server ack)
+- status poll throughput and latency
+- errors and reconnects
+
+Usage (from the web_server venv; simple-websocket comes with flask-sock):
+    python3 tools/load_test.py                          # 4 browsers, 20 s, https://localhost:5000
+    python3 tools/load_test.py --browsers 8 --duration 60
+    python3 tools/load_test.py --url https://192.168.1.50:5000
+"""
+
+import argparse
+import http.client
+import json
+import ssl
+import sys
+import threading
+import time
+from urllib.parse import urlparse
+
+NEUTRAL_NS = 1500000
+
+
+class BrowserStats:
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.joystick_sent = 0
+        self.joystick_rtt = []      # ms
+        self.status_latency = []    # ms
+        self.status_errors = 0
+        self.reconnects = 0
+        self.ws_error = None
+
+
+def make_ssl_context():
+    # The robot uses a self-signed certificate
+    ctx = ssl.create_default_context()
+    ctx.check_hostname = False
+    ctx.verify_mode = ssl.CERT_NONE
+    return ctx
+
+
+def joystick_client(url, rate, stop, stats):
+    """Joystick page: WebSocket in joystick mode, messages at `rate` Hz"""
+    import simple_websocket
+
+    ws_url = url.replace('https://', 'wss://').replace('http://', 'ws://') + '/motor'
+    try:
+        ws = simple_websocket.Client(ws_url, ssl_context=make_ssl_context() if ws_url.startswith('wss') else None)
+    except Exception as e:
+        stats.ws_error = str(e)
+        return
+
+    sent = {}  # seq -> send time
+
+    def receiver():
+        while not stop.is_set():
+            try:
+                message = ws.receive(timeout=0.5)
+            except Exception:
+                break
+            if message is None:
+                continue
+            now = time.perf_counter()
+            try:
+                data = json.loads(message)
+            except ValueError:
+                continue
+            seq = data.get('received', {}).get('seq') if data.get('type') == 'ack' else None
+            with stats.lock:
+                start = sent.pop(seq, None)
+                if start is not None:
+                    stats.joystick_rtt.append((now - start) * 1000)
+
+    rx = threading.Thread(target=receiver, daemon=True)
+    rx.start()
+
+    try:
+        ws.send(json.dumps({'type': 'set_mode', 'mode': 'joystick'}))
+        period = 1.0 / rate
+        next_send = time.perf_counter()
+        seq = 0
+        while not stop.is_set():
+            with stats.lock:
+                sent[seq] = time.perf_counter()
+                stats.joystick_sent += 1
+            ws.send(json.dumps({'type': 'joystick', 'leftNs': NEUTRAL_NS, 'rightNs': NEUTRAL_NS, 'seq': seq}))
+            seq += 1
+            # Fixed schedule, but never burst to catch up after a stall
+            next_send = max(next_send + period, time.perf_counter())
+            stop.wait(next_send - time.perf_counter())
+    except Exception as e:
+        stats.ws_error = str(e)
+    finally:
+        # Late acks still count
+        time.sleep(0.5)
+        try:
+            ws.close()
+        except Exception:
+            pass
+        rx.join(timeout=1)
+
+
+def status_client(url, rate, stop, stats):
+    """Course view: GET /api/navigation/status at `rate` Hz over one keep-alive connection"""
+    parsed = urlparse(url)
+    port = parsed.port or (443 if parsed.scheme == 'https' else 80)
+
+    def connect():
+        if parsed.scheme == 'https':
+            return http.client.HTTPSConnection(parsed.hostname, port, timeout=5, context=make_ssl_context())
+        return http.client.HTTPConnection(parsed.hostname, port, timeout=5)
+
+    conn = connect()
+    period = 1.0 / rate
+    next_poll = time.perf_counter()
+    while not stop.is_set():
+        start = time.perf_counter()
+        try:
+            conn.request('GET', '/api/navigation/status')
+            response = conn.getresponse()
+            response.read()
+            ok = response.status == 200
+        except (OSError, http.client.HTTPException):
+            ok = False
+            conn.close()
+            conn = connect()
+            with stats.lock:
+                stats.reconnects += 1
+        with stats.lock:
+            if ok:
+                stats.status_latency.append((time.perf_counter() - start) * 1000)
+            else:
+                stats.status_errors += 1
+        next_poll = max(next_poll + period, time.perf_counter())
+        stop.wait(next_poll - time.perf_counter())
+    conn.close()
+
+
+def print_latency(name, values, extra=''):
+    if not values:
+        print(f"{name:24s} {0:7d}  (no samples) {extra}")
+        return
+    values = sorted(values)
+    n = len(values)
+    p50 = values[n // 2]
+    p95 = values[min(n - 1, int(n * 0.95))]
+    p99 = values[min(n - 1, int(n * 0.99))]
+    print(f"{name:24s} {n:7d} {sum(values) / n:8.2f} {p50:8.2f} {p95:8.2f} {p99:8.2f} {values[-1]:8.2f}  {extra}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Load test the ASGC web server with simulated browsers")
+    parser.add_argument('--url', default='https://localhost:5000', help="Server base URL")
+    parser.add_argument('--browsers', type=int, default=4, help="Simulated browsers (default 4)")
+    parser.add_argument('--duration', type=float, default=20.0, help="Seconds to run (default 20)")
+    parser.add_argument('--joystick-hz', type=float, default=50.0, help="Joystick messages per second per browser")
+    parser.add_argument('--status-hz', type=float, default=30.0, help="Status polls per second per browser")
+    args = parser.parse_args()
+
+    try:
+        import simple_websocket  # noqa: F401
+    except ImportError:
+        print("simple-websocket not found. Run from the web_server venv (pip install -r web_server/requirements.txt).")
+        return 1
+
+    url = args.url.rstrip('/')
+    stop = threading.Event()
+    browsers = [BrowserStats() for _ in range(args.browsers)]
+    threads = []
+    for stats in browsers:
+        threads.append(threading.Thread(target=joystick_client, args=(url, args.joystick_hz, stop, stats), daemon=True))
+        threads.append(threading.Thread(target=status_client, args=(url, args.status_hz, stop, stats), daemon=True))
+
+    print(f"{args.browsers} browsers -> {url} for {args.duration:.0f} s "
+          f"(joystick {args.joystick_hz:.0f} Hz, status {args.status_hz:.0f} Hz each)")
+    start = time.perf_counter()
+    for t in threads:
+        t.start()
+    try:
+        stop.wait(args.duration)
+    except KeyboardInterrupt:
+        pass
+    stop.set()
+    for t in threads:
+        t.join(timeout=3)
+    elapsed = time.perf_counter() - start
+
+    rtt = [v for b in browsers for v in b.joystick_rtt]
+    status = [v for b in browsers for v in b.status_latency]
+    sent = sum(b.joystick_sent for b in browsers)
+    status_errors = sum(b.status_errors for b in browsers)
+    reconnects = sum(b.reconnects for b in browsers)
+
+    print(f"\n{'metric':24s} {'count':>7s} {'mean':>8s} {'p50':>8s} {'p95':>8s} {'p99':>8s} {'max':>8s}  (ms)")
+    print("-" * 90)
+    print_latency('joystick rtt', rtt, f"{len(rtt)}/{sent} acked")
+    print_latency('status poll', status, f"{len(status) / elapsed:.1f} req/s total, "
+                  f"{status_errors} errors, {reconnects} reconnects")
+    for i, b in enumerate(browsers):
+        if b.ws_error:
+            print(f"browser {i}: WebSocket error: {b.ws_error}")
+
+    target = args.browsers * args.status_hz
+    if status and len(status) / elapsed < 0.9 * target:
+        print(f"\nStatus throughput below the {target:.0f} req/s the browsers asked for")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -8,15 +8,46 @@ Features:
 - Auto-scaling for all data
 - Zoom, pan, and legend controls
 - Color-coded navigation states
+- Live mode: real-time plots from the controller's shared-memory ring
 """
 
 import pandas as pd
+import numpy as np
 import matplotlib.pyplot as plt
 from matplotlib.widgets import Button
+from matplotlib.animation import FuncAnimation
 import tkinter as tk
 from tkinter import filedialog
+import mmap
 import sys
 import os
+import time
+
+# Live telemetry ring written by the controller (c_code/include/telemetry.h)
+RING_PATH = '/dev/shm/asgc_telemetry'
+RING_MAGIC = 0x43475341
+RING_VERSION = 1
+RING_HEADER_SIZE = 64
+RING_HEADER_DTYPE = np.dtype([
+    ('magic', '<u4'), ('version', '<u4'), ('entry_size', '<u4'),
+    ('capacity', '<u4'), ('write_index', '<u8')
+])
+# Mirrors LogEntry, align=True reproduces the C struct padding
+ENTRY_DTYPE = np.dtype([
+    ('time', '<f8'),
+    ('target_l', '<i4'), ('actual_l', '<i4'), ('pulse_l', '<i4'), ('raw_l', '<i4'),
+    ('target_r', '<i4'), ('actual_r', '<i4'), ('pulse_r', '<i4'), ('raw_r', '<i4'),
+    ('mode', 'i1'),
+    ('gyro_z', '<f8'),
+    ('odom_x', '<f8'), ('odom_y', '<f8'), ('odom_heading', '<f8'),
+    ('nav_state', 'i1')
+], align=True)
+MODE_NAMES = ['IDLE', 'JOYSTICK', 'VOICE']
+NAV_STATE_NAMES = ['IDLE', 'TURNING', 'DRIVING', 'GOTO']
+CONTROL_RATE_HZ = 200
+# Slots left between the live window and the writer: the oldest slots of a full
+# ring are the next ones the controller overwrites (1 s at 200 Hz)
+RING_MARGIN = CONTROL_RATE_HZ
 
 class LogViewer:
     def __init__(self, initial_file=None):
@@ -385,6 +416,152 @@ class LogViewer:
         # Show interactive plot
         plt.show()
 
+class LiveLogViewer:
+    """Real-time plots tailing the controller's shared-memory telemetry ring"""
+
+    def __init__(self, window_sec=20.0):
+        self.window_sec = window_sec
+        self.mm = None
+        self.header = None
+        self.entries = None
+        self.capacity = 0
+        self.fig = None
+        self.lines = {}
+        self.animation = None
+
+    def open_ring(self):
+        """Map the ring read-only, waiting for the controller to create it"""
+        print(f"Waiting for telemetry ring at {RING_PATH}...")
+        while True:
+            try:
+                with open(RING_PATH, 'rb') as f:
+                    mm = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+                header = np.frombuffer(mm, dtype=RING_HEADER_DTYPE, count=1)
+                if header['magic'][0] == RING_MAGIC:
+                    break
+                mm.close()
+            except (FileNotFoundError, ValueError):
+                pass  # Not created yet, or still empty
+            time.sleep(0.5)
+
+        if header['version'][0] != RING_VERSION or header['entry_size'][0] != ENTRY_DTYPE.itemsize:
+            print(f"Ring layout mismatch (version {header['version'][0]}, "
+                  f"entry size {header['entry_size'][0]} vs {ENTRY_DTYPE.itemsize}). Rebuild the tools?")
+            return False
+
+        # Views straight into the mapping - nothing is copied until plotting
+        self.mm = mm
+        self.header = header
+        self.capacity = int(header['capacity'][0])
+        self.entries = np.frombuffer(mm, dtype=ENTRY_DTYPE, count=self.capacity, offset=RING_HEADER_SIZE)
+        print(f"Attached to telemetry ring ({self.capacity} entries)")
+        return True
+
+    def latest(self):
+        """Return a copy of the newest window of entries, without slots the writer reused"""
+        write_index = int(self.header['write_index'][0])
+        count = min(write_index, self.capacity - RING_MARGIN, int(self.window_sec * CONTROL_RATE_HZ))
+        if count <= 0:
+            return None
+
+        # Copy out of the mapping: plotting later would read whatever the writer put there since
+        start = (write_index - count) % self.capacity
+        if start + count <= self.capacity:
+            data = self.entries[start:start + count].copy()
+        else:
+            data = np.concatenate((self.entries[start:], self.entries[:(start + count) % self.capacity]))
+
+        # The writer kept going during the copy. Entry n is intact while the writer
+        # is still below n + capacity (slot n is rewritten as entry n + capacity)
+        first = write_index - count
+        reused = int(self.header['write_index'][0]) + 1 - self.capacity - first
+        if reused > 0:
+            data = data[reused:]
+        return data if len(data) else None
+
+    def create_plots(self):
+        """Create the live panels"""
+        self.fig, axes = plt.subplots(2, 2, figsize=(14, 9))
+        self.axes = axes
+
+        ax = axes[0, 0]
+        self.lines['pulse_l'], = ax.plot([], [], 'b-', label='Left PWM', linewidth=1)
+        self.lines['pulse_r'], = ax.plot([], [], 'r-', label='Right PWM', linewidth=1)
+        ax.set_ylabel('PWM (ns)')
+        ax.set_title('Motor PWM Commands')
+        ax.legend(loc='upper left')
+        ax.grid(True, alpha=0.3)
+
+        ax = axes[0, 1]
+        self.lines['target_l'], = ax.plot([], [], 'b--', label='Left Target', linewidth=1.5)
+        self.lines['actual_l'], = ax.plot([], [], 'b-', label='Left Actual', linewidth=1)
+        self.lines['target_r'], = ax.plot([], [], 'r--', label='Right Target', linewidth=1.5)
+        self.lines['actual_r'], = ax.plot([], [], 'r-', label='Right Actual', linewidth=1)
+        ax.set_ylabel('Counts')
+        ax.set_title('Target vs Actual')
+        ax.legend(loc='upper left')
+        ax.grid(True, alpha=0.3)
+
+        ax = axes[1, 0]
+        self.lines['gyro_z'], = ax.plot([], [], 'g-', label='Gyro Z', linewidth=1)
+        ax.axhline(y=0, color='k', linestyle='--', alpha=0.3)
+        ax.set_ylabel('Angular Rate (deg/s)')
+        ax.set_xlabel('Time (seconds)')
+        ax.set_title('MPU6050 Gyro Z-axis')
+        ax.legend(loc='upper left')
+        ax.grid(True, alpha=0.3)
+
+        ax = axes[1, 1]
+        ax.plot([0, 30, 30, 0, 0], [0, 0, 30, 30, 0], 'k-', linewidth=2)
+        for (x, y), color in (((0, 0), 'red'), ((0, 30), 'gold'), ((30, 30), 'blue'), ((30, 0), 'green')):
+            ax.plot(x, y, 'o', color=color, markersize=12, markeredgecolor='black', markeredgewidth=1.5)
+        ax.plot(15, 15, 'x', color='purple', markersize=10, markeredgewidth=2)
+        self.lines['path'], = ax.plot([], [], 'c-', linewidth=1.5)
+        self.lines['robot'], = ax.plot([], [], 'rs', markersize=10, markeredgecolor='black')
+        ax.set_xlabel('X Position (feet)')
+        ax.set_ylabel('Y Position (feet)')
+        ax.set_title('Robot Path')
+        ax.set_xlim(-2, 32)
+        ax.set_ylim(-2, 32)
+        ax.set_aspect('equal')
+        ax.grid(True, alpha=0.3)
+
+        plt.tight_layout(rect=[0, 0, 1, 0.95])
+
+    def update(self, frame):
+        """Animation callback: redraw from the newest ring contents"""
+        data = self.latest()
+        if data is None:
+            return []
+
+        t = data['time']
+        for key in ('pulse_l', 'pulse_r', 'target_l', 'actual_l', 'target_r', 'actual_r', 'gyro_z'):
+            self.lines[key].set_data(t, data[key])
+        self.lines['path'].set_data(data['odom_x'], data['odom_y'])
+        self.lines['robot'].set_data([data['odom_x'][-1]], [data['odom_y'][-1]])
+
+        for ax in (self.axes[0, 0], self.axes[0, 1], self.axes[1, 0]):
+            ax.set_xlim(t[-1] - self.window_sec, t[-1] + 0.1)
+            ax.relim()
+            ax.autoscale_view(scalex=False)
+
+        last = data[-1]
+        mode = MODE_NAMES[last['mode']] if 0 <= last['mode'] < len(MODE_NAMES) else '?'
+        state = NAV_STATE_NAMES[last['nav_state']] if 0 <= last['nav_state'] < len(NAV_STATE_NAMES) else '?'
+        self.fig.suptitle(f"LIVE  t={last['time']:.1f}s  mode={mode}  nav={state}  "
+                          f"pos=({last['odom_x']:.2f}, {last['odom_y']:.2f}) @ {last['odom_heading']:.1f}°",
+                          fontsize=13, fontweight='bold')
+        return list(self.lines.values())
+
+    def run(self):
+        """Main execution flow"""
+        if not self.open_ring():
+            return
+        self.create_plots()
+        self.animation = FuncAnimation(self.fig, self.update, interval=100, cache_frame_data=False)
+        plt.show()
+
+
 def main():
     """Entry point"""
     print("=" * 60)
@@ -396,6 +573,7 @@ def main():
     print("  • Zoom and pan controls")
     print("  • Navigation state visualization")
     print("  • MPU6050 gyro and odometry data")
+    print("  • Live mode: log_viewer.py --live [window_sec]")
     print("\nControls:")
     print("  • Left click + drag: Pan")
     print("  • Right click + drag: Zoom")
@@ -405,6 +583,12 @@ def main():
     print("=" * 60)
     print()
     
+    # Live mode: tail the controller's telemetry ring during a run
+    if len(sys.argv) > 1 and sys.argv[1] == '--live':
+        window_sec = float(sys.argv[2]) if len(sys.argv) > 2 else 20.0
+        LiveLogViewer(window_sec).run()
+        return
+
     # Check for command line argument
     initial_file = None
     if len(sys.argv) > 1:
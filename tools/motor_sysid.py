@@ -0,0 +1,254 @@
+#!/usr/bin/env python3
+"""
+Motor System Identification for ASGC Motor Control Logs
+
+Finds pulse changes in logged runs, extracts the step responses and fits a
+per-wheel model:
+- Deadband: pulse offset from neutral before the wheel moves (ns)
+- Gain: steady-state speed per pulse offset beyond the deadband (counts/sec per us)
+- Time constant and dead time (first order plus dead time, two-point method)
+- Coast-down deceleration at neutral (counts/sec^2)
+
+Results are merged into c_code/motor_params.conf, which the motor controller
+loads at startup (see c_code/include/params.h).
+
+Usage:
+    python3 motor_sysid.py ../logs/motor_log_joystick_*.csv
+    python3 motor_sysid.py --output /tmp/params.conf log1.csv log2.csv
+"""
+
+import argparse
+import glob
+import os
+import sys
+
+import numpy as np
+import pandas as pd
+
+NEUTRAL_NS = 1500000
+COUNTS_PER_REV = 4096
+
+# Step detection
+MIN_STEP_NS = 20000        # Ignore pulse changes smaller than 20us
+HOLD_TOLERANCE_NS = 5000   # Pulse must stay within 5us of the new value...
+MIN_HOLD_SEC = 0.3         # ...for at least this long to count as a step
+PRE_STEP_SEC = 0.05        # Window before the step used for the initial speed
+NEUTRAL_BAND_NS = 10000    # Pulses within 10us of neutral count as coasting
+
+# Fitting
+MOVING_SPEED = 200.0       # counts/sec, below this the wheel is considered stopped
+VELOCITY_SMOOTHING = 5     # Samples in the velocity moving average
+
+WHEELS = {'left': ('pwm_l', 'i2c_l'), 'right': ('pwm_r', 'i2c_r')}
+
+tools_dir = os.path.dirname(os.path.abspath(__file__))
+DEFAULT_PARAMS_FILE = os.path.abspath(os.path.join(tools_dir, "../c_code/motor_params.conf"))
+
+
+def wheel_velocity(time, raw):
+    """Unwrap raw AS5600 angles and return (position, velocity) in counts and counts/sec"""
+    delta = np.diff(raw.astype(np.int64))
+    # Shortest path across the 4095 -> 0 boundary
+    delta = (delta + COUNTS_PER_REV // 2) % COUNTS_PER_REV - COUNTS_PER_REV // 2
+    position = np.concatenate(([0], np.cumsum(delta)))
+
+    dt = np.diff(time)
+    dt[dt <= 0] = np.nan
+    velocity = np.concatenate(([0.0], delta / dt))
+    velocity = np.nan_to_num(velocity)
+
+    kernel = np.ones(VELOCITY_SMOOTHING) / VELOCITY_SMOOTHING
+    velocity = np.convolve(velocity, kernel, mode='same')
+    return position, velocity
+
+
+def find_steps(time, pulse):
+    """Return (start, end) index pairs where the pulse steps and then holds"""
+    steps = []
+    change_idx = np.flatnonzero(np.abs(np.diff(pulse)) >= MIN_STEP_NS) + 1
+
+    for start in change_idx:
+        level = pulse[start]
+        end = start
+        while end + 1 < len(pulse) and abs(pulse[end + 1] - level) <= HOLD_TOLERANCE_NS:
+            end += 1
+        if time[end] - time[start] >= MIN_HOLD_SEC:
+            steps.append((start, end))
+    return steps
+
+
+def analyze_step(time, pulse, velocity, start, end):
+    """Extract one step response. Returns a dict, or None if it is unusable"""
+    pre = (time >= time[start] - PRE_STEP_SEC) & (np.arange(len(time)) < start)
+    if not pre.any():
+        return None
+
+    t = time[start:end + 1] - time[start]
+    v = velocity[start:end + 1]
+    v0 = float(np.median(velocity[pre]))
+    offset = float(pulse[start] - NEUTRAL_NS)
+
+    # Steady state from the last 30% of the hold
+    tail = t >= 0.7 * t[-1]
+    v_ss = float(np.median(v[tail]))
+
+    step = {'offset_ns': offset, 'v0': v0, 'v_ss': v_ss,
+            'tau': None, 'dead_time': None, 'coast_decel': None}
+
+    if abs(offset) < NEUTRAL_BAND_NS:
+        # Coast-down: fit the deceleration while the wheel is still clearly moving
+        if abs(v0) < 5 * MOVING_SPEED:
+            return None
+        moving = np.abs(v) > max(MOVING_SPEED, 0.1 * abs(v0))
+        moving &= np.cumprod(moving).astype(bool)  # Only the initial run-down
+        if moving.sum() < 5:
+            return None
+        slope = np.polyfit(t[moving], np.abs(v[moving]), 1)[0]
+        if slope < 0:
+            step['coast_decel'] = float(-slope)
+        return step
+
+    dv = v_ss - v0
+    if abs(dv) < MOVING_SPEED:
+        return step  # No transient to time. fit_gain still uses v_ss if the wheel is moving
+
+    # Smith's two-point method: 28.3% and 63.2% crossings
+    frac = (v - v0) / dv
+    reached_28 = np.flatnonzero(frac >= 0.283)
+    reached_63 = np.flatnonzero(frac >= 0.632)
+    if len(reached_28) and len(reached_63):
+        t28 = t[reached_28[0]]
+        t63 = t[reached_63[0]]
+        tau = 1.5 * (t63 - t28)
+        if tau > 0:
+            step['tau'] = float(tau)
+            step['dead_time'] = float(max(0.0, t63 - tau))
+    return step
+
+
+def fit_gain(steps):
+    """Fit v_ss = gain * (offset - sign(offset) * deadband) over moving steps"""
+    moving = [s for s in steps
+              if abs(s['offset_ns']) >= NEUTRAL_BAND_NS and abs(s['v_ss']) >= MOVING_SPEED]
+    if len(moving) < 2:
+        return None, None
+
+    offset_us = np.array([s['offset_ns'] for s in moving]) / 1000.0
+    v_ss = np.array([s['v_ss'] for s in moving])
+    A = np.column_stack((offset_us, np.sign(offset_us)))
+    (gain, intercept), *_ = np.linalg.lstsq(A, v_ss, rcond=None)
+    if gain == 0:
+        return None, None
+
+    deadband_ns = max(0.0, -intercept / gain * 1000.0)
+    return float(gain), float(deadband_ns)
+
+
+def identify_wheel(frames, wheel):
+    """Identify the model for one wheel across all loaded logs"""
+    pulse_col, raw_col = WHEELS[wheel]
+    steps = []
+    for df in frames:
+        time = df['time'].to_numpy(dtype=float)
+        pulse = df[pulse_col].to_numpy(dtype=np.int64)
+        _, velocity = wheel_velocity(time, df[raw_col].to_numpy())
+
+        for start, end in find_steps(time, pulse):
+            step = analyze_step(time, pulse, velocity, start, end)
+            if step:
+                steps.append(step)
+
+    model = {}
+    gain, deadband_ns = fit_gain(steps)
+    if gain is not None:
+        model['gain'] = gain
+        model['deadband_ns'] = deadband_ns
+
+    for key in ('tau', 'dead_time', 'coast_decel'):
+        values = [s[key] for s in steps if s[key] is not None]
+        if values:
+            model[key] = float(np.median(values))
+
+    print(f"{wheel:5s}: {len(steps)} usable steps")
+    for key, value in model.items():
+        print(f"    {key:12s} = {value:.6g}")
+    return model
+
+
+def read_params(path):
+    """Read an existing parameter file as an ordered dict of key -> value string"""
+    params = {}
+    if not os.path.exists(path):
+        return params
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if not line or line.startswith('#') or '=' not in line:
+                continue
+            key, value = line.split('=', 1)
+            params[key.strip()] = value.strip()
+    return params
+
+
+def write_params(path, params, sources):
+    """Write parameters in the key = value format read by params_load()"""
+    temp_path = path + ".tmp"
+    with open(temp_path, 'w') as f:
+        f.write("# ASGC motor parameters (see c_code/include/params.h for units)\n")
+        f.write(f"# Model identified by tools/motor_sysid.py from {len(sources)} log(s)\n")
+        for wheel in WHEELS:
+            f.write("\n")
+            for key, value in params.items():
+                if key.startswith(wheel + '.'):
+                    f.write(f"{key} = {value}\n")
+        for key, value in params.items():
+            if not any(key.startswith(wheel + '.') for wheel in WHEELS):
+                f.write(f"{key} = {value}\n")
+    os.replace(temp_path, path)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Fit per-wheel motor models from logged step responses")
+    parser.add_argument('logs', nargs='+', help="CSV log files from dump_log() (globs allowed)")
+    parser.add_argument('--output', default=DEFAULT_PARAMS_FILE,
+                        help=f"Parameter file to update (default: {DEFAULT_PARAMS_FILE})")
+    parser.add_argument('--dry-run', action='store_true', help="Print the model without writing it")
+    args = parser.parse_args()
+
+    files = []
+    for pattern in args.logs:
+        files.extend(sorted(glob.glob(pattern)) or [pattern])
+
+    frames = []
+    for filename in files:
+        try:
+            frames.append(pd.read_csv(filename))
+            print(f"Loaded {len(frames[-1])} samples from {os.path.basename(filename)}")
+        except Exception as e:
+            print(f"Error loading {filename}: {e}")
+    if not frames:
+        print("No logs loaded!")
+        return 1
+
+    params = read_params(args.output)
+    found = False
+    for wheel in WHEELS:
+        model = identify_wheel(frames, wheel)
+        for key, value in model.items():
+            params[f"{wheel}.{key}"] = f"{value:.6g}"
+            found = True
+
+    if not found:
+        print("No usable step responses found. Log a joystick run with distinct pulse steps.")
+        return 1
+
+    if args.dry_run:
+        return 0
+
+    write_params(args.output, params, files)
+    print(f"Saved model to {args.output}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
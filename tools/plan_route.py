@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+"""
+Route Leg Export for the Batch Simulator
+
+Prints the goto commands the navigation queue sends for a list of targets
+queued at once, using the web server's leg planner (web_server/navigation_legs.py
+and the leg policies in course_config.py). asgc_batch_sim --legs drives exactly
+these legs, so a policy change is simulated from the same source the robot uses.
+
+Output: a "# <TARGET>" line per queued command, then one goto line per leg.
+
+Usage:
+    python3 tools/plan_route.py yellow blue green red > route.legs
+    cd c_code && ./asgc_batch_sim --legs ../route.legs
+    python3 ../tools/plan_route.py yellow,center,red | ./asgc_batch_sim --legs -
+"""
+
+import argparse
+import os
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'web_server'))
+
+from course_config import CENTER, START_POSITION, get_bucket_position  # noqa: E402
+from navigation_legs import plan_legs, leg_arrival, goto_command  # noqa: E402
+
+
+def plan_route(targets):
+    """[(target, [goto line, ...])] for targets queued in order"""
+    commands = []
+    for name in targets:
+        if name.lower() == 'center':
+            commands.append(('center', 'CENTER', CENTER))
+            continue
+        position = get_bucket_position(name)
+        if position is None:
+            raise ValueError(f"Unknown target '{name}' (bucket color or center)")
+        commands.append(('bucket', name.upper(), position))
+
+    # Like queue_command(): each command's legs start where the previous one ends
+    route = []
+    start = START_POSITION
+    for i, (command_type, target, position) in enumerate(commands):
+        more_commands = i + 1 < len(commands)
+        legs = plan_legs(command_type, start, position)
+        route.append((target, [goto_command(leg, leg_arrival(leg, more_commands)) for leg in legs]))
+        start = position
+    return route
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Print navigation queue legs for asgc_batch_sim --legs")
+    parser.add_argument('targets', nargs='+', help="Bucket colors or center, in order (also comma separated)")
+    args = parser.parse_args()
+
+    targets = [t for arg in args.targets for t in arg.split(',') if t]
+    try:
+        route = plan_route(targets)
+    except ValueError as e:
+        print(f"ERROR: {e}", file=sys.stderr)
+        return 1
+
+    for target, commands in route:
+        print(f"# {target}")
+        for command in commands:
+            print(command)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
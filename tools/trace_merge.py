@@ -0,0 +1,182 @@
+#!/usr/bin/env python3
+"""
+Trace Merger for ASGC Web, Voice and Controller Events
+
+Combines the trace files written with ASGC_TRACE=1 (web server) and
+--trace (C controller) into one timeline. All processes stamp events with
+CLOCK_MONOTONIC, so no clock alignment is needed.
+
+Features:
+- Merged, time-ordered timeline with per-event deltas
+- Latency summary for each hop (voice -> queue -> pipe -> controller -> motion)
+- Optional swimlane plot (one row per component)
+
+Usage:
+    python3 trace_merge.py                     # /dev/shm/asgc_trace_*.log
+    python3 trace_merge.py --summary           # latency table only
+    python3 trace_merge.py --plot
+    python3 trace_merge.py web.log controller.log
+"""
+
+import argparse
+import glob
+import sys
+
+DEFAULT_PATTERN = '/dev/shm/asgc_trace_*.log'
+
+# Display order, upstream to downstream
+SOURCES = ['sockets', 'voice', 'navigation', 'motor_interface', 'controller']
+
+# Latency hops: (name, start (source, event[, detail prefix]), end (source, event[, detail prefix]), match)
+# match='detail' pairs events with identical details (e.g. the same command string)
+# match='next' pairs a start with the next end event after it
+HOPS = [
+    ('voice -> queued',        ('sockets', 'voice_final'),         ('voice', 'voice_queue'),              'next'),
+    ('joystick ws -> pipe',    ('sockets', 'ws_joystick'),         ('motor_interface', 'cmd_write'),      'detail'),
+    ('command queue wait',     ('motor_interface', 'cmd_queue'),   ('motor_interface', 'cmd_write'),      'detail'),
+    ('stdin pipe -> C',        ('motor_interface', 'cmd_write'),   ('controller', 'cmd_recv'),            'detail'),
+    ('goto -> motion start',   ('controller', 'cmd_recv', 'goto'), ('controller', ('nav_turn', 'nav_drive', 'nav_arrived')), 'next'),
+    ('arrived -> Python',      ('controller', 'nav_arrived'),      ('motor_interface', 'status_state'),   'next'),
+    ('leg gap (arrive -> next goto)', ('controller', 'nav_arrived'), ('controller', 'cmd_recv', 'goto'), 'next'),
+]
+
+
+def load_events(files):
+    """Read (time, source, event, detail) tuples from all trace files"""
+    events = []
+    for filename in files:
+        try:
+            with open(filename) as f:
+                for line in f:
+                    parts = line.rstrip('\n').split('\t')
+                    if len(parts) < 3:
+                        continue
+                    try:
+                        t = float(parts[0])
+                    except ValueError:
+                        continue
+                    detail = parts[3] if len(parts) > 3 else ''
+                    events.append((t, parts[1], parts[2], detail))
+        except OSError as e:
+            print(f"Error reading {filename}: {e}")
+    events.sort(key=lambda e: e[0])
+    return events
+
+
+def print_timeline(events):
+    """Print the merged timeline, one column block per source"""
+    t0 = events[0][0]
+    prev = t0
+    print(f"{'time (s)':>10s} {'+ms':>8s}  {'source':16s} {'event':16s} detail")
+    print("-" * 80)
+    for t, source, event, detail in events:
+        print(f"{t - t0:10.4f} {(t - prev) * 1000:8.2f}  {source:16s} {event:16s} {detail}")
+        prev = t
+
+
+def _matches(event, spec):
+    source, names = spec[:2]
+    if isinstance(names, str):
+        names = (names,)
+    # Optional detail prefix, e.g. only 'goto' commands among cmd_recv
+    prefix = spec[2] if len(spec) > 2 else ''
+    return event[1] == source and event[2] in names and event[3].startswith(prefix)
+
+
+def measure_hops(events):
+    """Return {hop name: [latency_ms, ...]}"""
+    results = {}
+    for name, start_spec, end_spec, match in HOPS:
+        latencies = []
+        pending = {}   # detail -> [start times] for 'detail' matching
+        waiting = []   # start times for 'next' matching
+
+        for event in events:
+            # Check end first so an event that is both end and start (e.g. cmd_recv) closes the older hop
+            if _matches(event, end_spec):
+                if match == 'detail':
+                    starts = pending.get(event[3])
+                    if starts:
+                        latencies.append((event[0] - starts.pop(0)) * 1000)
+                elif waiting:
+                    latencies.append((event[0] - waiting[0]) * 1000)
+                    waiting = []
+            if _matches(event, start_spec):
+                if match == 'detail':
+                    pending.setdefault(event[3], []).append(event[0])
+                elif not waiting:
+                    waiting.append(event[0])
+        results[name] = latencies
+    return results
+
+
+def print_summary(events):
+    """Print latency statistics per hop"""
+    print(f"\n{'hop':32s} {'count':>6s} {'mean':>8s} {'p50':>8s} {'p95':>8s} {'max':>8s}  (ms)")
+    print("-" * 80)
+    for name, latencies in measure_hops(events).items():
+        if not latencies:
+            print(f"{name:32s} {0:6d}")
+            continue
+        values = sorted(latencies)
+        n = len(values)
+        p50 = values[n // 2]
+        p95 = values[min(n - 1, int(n * 0.95))]
+        print(f"{name:32s} {n:6d} {sum(values) / n:8.2f} {p50:8.2f} {p95:8.2f} {values[-1]:8.2f}")
+
+
+def plot_timeline(events):
+    """Swimlane view: one row per source, events labelled in place"""
+    import matplotlib.pyplot as plt
+
+    sources = [s for s in SOURCES if any(e[1] == s for e in events)]
+    sources += sorted({e[1] for e in events} - set(sources))
+    rows = {s: i for i, s in enumerate(reversed(sources))}
+    t0 = events[0][0]
+
+    fig, ax = plt.subplots(figsize=(16, 2 + len(sources)))
+    for t, source, event, detail in events:
+        y = rows[source]
+        ax.plot(t - t0, y, '|', markersize=14, color=f"C{y}")
+        ax.annotate(event, (t - t0, y), xytext=(0, 8), textcoords='offset points',
+                    rotation=45, fontsize=7)
+
+    ax.set_yticks(list(rows.values()))
+    ax.set_yticklabels(list(rows.keys()))
+    ax.set_ylim(-0.5, len(sources))
+    ax.set_xlabel('Time (seconds)')
+    ax.set_title('ASGC Cross-Process Timeline')
+    ax.grid(True, axis='x', alpha=0.3)
+    plt.tight_layout()
+    plt.show()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Merge ASGC trace files into one timeline")
+    parser.add_argument('files', nargs='*', help=f"Trace files (default: {DEFAULT_PATTERN})")
+    parser.add_argument('--summary', action='store_true', help="Only print the latency summary")
+    parser.add_argument('--plot', action='store_true', help="Show a swimlane plot")
+    args = parser.parse_args()
+
+    files = args.files or sorted(glob.glob(DEFAULT_PATTERN))
+    if not files:
+        print(f"No trace files found. Start the server with ASGC_TRACE=1 ({DEFAULT_PATTERN}).")
+        return 1
+
+    events = load_events(files)
+    if not events:
+        print("Trace files are empty.")
+        return 1
+    print(f"Merged {len(events)} events from {len(files)} file(s)\n")
+
+    if not args.summary:
+        print_timeline(events)
+    print_summary(events)
+
+    if args.plot:
+        plot_timeline(events)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -9,8 +9,8 @@ if [ ! -d "venv" ]; then
     echo "Virtual environment not found. Creating..."
     python3 -m venv venv
     echo "Installing dependencies..."
-    ./venv/bin/pip install pandas matplotlib
+    ./venv/bin/pip install pandas numpy matplotlib
 fi
 
-# Run the log viewer with venv Python
-./venv/bin/python3 log_viewer.py
+# Run the log viewer with venv Python (pass --live for real-time view)
+./venv/bin/python3 log_viewer.py "$@"
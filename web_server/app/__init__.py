@@ -1,7 +1,7 @@
 from flask import Flask
 from .config import Config
 from .routes import bp as main_bp
-from .sockets import sock, init_model
+from .sockets import sock, start_model_loading
 from .motor_interface import motor_interface
 import sys
 import os
@@ -27,6 +27,10 @@ def create_app():
     log = logging.getLogger('werkzeug')
     log.addFilter(StatusEndpointFilter())
 
+    # Ping idle WebSockets so a phone that drops off Wi-Fi is noticed and its
+    # server thread freed, instead of blocking in receive() forever
+    app.config['SOCK_SERVER_OPTIONS'] = {'ping_interval': 25}
+
     # Initialize Sock
     sock.init_app(app)
     
@@ -69,7 +73,7 @@ def create_app():
     except Exception as e:
         print(f"Failed to initialize navigation: {e}")
 
-    # Initialize Vosk Model
-    init_model()
+    # Load Vosk model in the background; joystick and navigation don't need it
+    start_model_loading()
 
     return app
@@ -4,6 +4,7 @@ import queue
 import os
 import sys
 from .config import Config
+from .trace import TRACE_ENABLED, trace
 
 class MotorInterface:
     def __init__(self):
@@ -12,6 +13,7 @@ class MotorInterface:
         self.lock = threading.Lock()
         self.nav_controller = None
         self.running = False
+        self.last_state = None  # For tracing state changes only
 
     def start(self, nav_controller=None):
         """Starts the motor control subprocess."""
@@ -47,8 +49,11 @@ class MotorInterface:
 
         try:
             with self.lock:
+                args = ['sudo', motor_path]
+                if TRACE_ENABLED:
+                    args.append('--trace')
                 self.process = subprocess.Popen(
-                    ['sudo', motor_path],
+                    args,
                     stdin=subprocess.PIPE,
                     stdout=subprocess.PIPE,
                     stderr=subprocess.PIPE,
@@ -86,6 +91,7 @@ class MotorInterface:
 
     def send_command(self, command):
         """Queue a command to be sent to the motor control program."""
+        trace('motor_interface', 'cmd_queue', command)
         self.command_queue.put(command)
 
     def _send_commands(self):
@@ -96,6 +102,7 @@ class MotorInterface:
                 if command and self.process and self.process.stdin:
                     self.process.stdin.write(command + '\n')
                     self.process.stdin.flush()
+                    trace('motor_interface', 'cmd_write', command)
             except queue.Empty:
                 continue
             except Exception as e:
@@ -116,11 +123,31 @@ class MotorInterface:
 
     def _handle_motor_feedback(self, line):
         """Parses motor feedback and updates navigation controller."""
+        parts = line.split()
+        if not parts:
+            return
+
+        if parts[0] != "STATUS":
+            trace('motor_interface', 'feedback', line)
+
+        # Autotune progress and results
+        if parts[0] == "AUTOTUNE" or (len(parts) > 1 and parts[1] == "autotune"):
+            print(f"[MOTOR] {line}")
+            return
+
+        # Landmark pose corrections (position itself arrives with the next STATUS)
+        if parts[0] == "LANDMARK" or (len(parts) > 1 and parts[1] == "landmark"):
+            print(f"[MOTOR] {line}")
+
         if not self.nav_controller:
             return
 
-        parts = line.split()
-        if not parts:
+        # Navigation aborted by the controller: drop the queue before the IDLE status
+        # would start the next leg
+        if parts[0] == "NAVERROR":
+            print(f"[MOTOR] {line}")
+            if hasattr(self.nav_controller, 'clear_queue'):
+                self.nav_controller.clear_queue()
             return
 
         if parts[0] == "STATUS" and len(parts) >= 5:
@@ -129,6 +156,9 @@ class MotorInterface:
                 y = float(parts[2])
                 h = float(parts[3])
                 s = int(parts[4])
+                if s != self.last_state:
+                    trace('motor_interface', 'status_state', str(s))
+                    self.last_state = s
                 if hasattr(self.nav_controller, 'handle_status_update'):
                     self.nav_controller.handle_status_update(x, y, h, s)
             except ValueError:
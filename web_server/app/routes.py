@@ -1,6 +1,7 @@
 from flask import Blueprint, render_template, jsonify
 from .config import Config
 from .motor_interface import motor_interface
+from .sockets import get_model_status
 
 # Note: nav_controller is accessed via motor_interface.nav_controller
 # This avoids circular imports and ensures we use the active controller instance.
@@ -52,6 +53,24 @@ def api_goto_bucket(color):
     else:
         return jsonify({'error': 'Navigation not initialized'}), 503
 
+@bp.route('/api/navigation/landmark/<color>', methods=['POST'])
+def api_landmark(color):
+    """Correct pose: robot is touching the specified bucket."""
+    if motor_interface.nav_controller:
+        bucket_pos = Config.get_bucket_position(color)
+        if bucket_pos:
+            motor_interface.nav_controller.report_landmark(color)
+            return jsonify({'status': 'landmark', 'target': color, 'position': bucket_pos})
+        else:
+            return jsonify({'error': f'Unknown bucket color: {color}'}), 400
+    else:
+        return jsonify({'error': 'Navigation not initialized'}), 503
+
+@bp.route('/api/voice/status')
+def get_voice_status():
+    """Get voice model readiness (loading, ready or failed)."""
+    return jsonify(get_model_status())
+
 @bp.route('/api/course/info')
 def get_course_info():
     """Get course layout information."""
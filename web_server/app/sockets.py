@@ -1,41 +1,78 @@
 import json
+import threading
+import time
 import vosk
 from flask_sock import Sock
 from .config import Config
 from .motor_interface import motor_interface
 from .voice_command import VoiceCommandProcessor
+from .trace import trace
 
 sock = Sock()
 
-# Global model variable (loaded in create_app or lazily)
+# Global model variable (loaded in the background by start_model_loading)
 model = None
 
+# Model readiness: 'idle' -> 'loading' -> 'ready' | 'failed'
+model_state = 'idle'
+model_error = None
+model_load_time = None
+model_ready = threading.Event()  # Set once loading finishes, successfully or not
+
 # Global set of connected motor control WebSocket clients
 motor_clients = set()
 
 def init_model():
-    global model
+    global model, model_state, model_error, model_load_time
     print("Loading Vosk model...")
+    model_state = 'loading'
+    start = time.monotonic()
     try:
         # Set log level to reduce Vosk verbosity
         vosk.SetLogLevel(-1)
         model = vosk.Model(Config.MODEL_PATH)
-        print("Model loaded successfully.")
+        model_load_time = time.monotonic() - start
+        model_state = 'ready'
+        print(f"Model loaded successfully ({model_load_time:.1f}s).")
     except Exception as e:
         print(f"Error loading model: {e}")
         print(f"Please make sure the 'model' folder is at {Config.MODEL_PATH}")
         model = None
+        model_error = str(e)
+        model_state = 'failed'
+    finally:
+        model_ready.set()
+
+def start_model_loading():
+    """Load the Vosk model on a background thread so the server starts immediately."""
+    if model_state != 'idle':
+        return
+    thread = threading.Thread(target=init_model, name='vosk-loader', daemon=True)
+    thread.start()
+
+def get_model_status():
+    """Voice model readiness for /api/voice/status and /audio clients."""
+    return {'state': model_state, 'error': model_error, 'load_time': model_load_time}
 
 @sock.route('/audio')
 def audio_socket(ws):
     """Handles the WebSocket connection for audio streaming."""
     print("Client connected.")
 
+    # Keep the connection open while the model loads, so the page shows progress
+    if not model_ready.is_set():
+        print("Vosk model still loading. Client waiting.")
+        ws.send(json.dumps({'type': 'status', 'state': 'warming_up'}))
+        model_ready.wait()
+
     if not model:
         print("Vosk model not loaded. Voice control unavailable.")
+        ws.send(json.dumps({'type': 'status', 'state': 'failed', 'error': model_error}))
         ws.close()
         return
 
+    ws.send(json.dumps({'type': 'status', 'state': 'ready'}))
+
     # Suppress Vosk warnings about runtime graphs
     vosk.SetLogLevel(-1)
 
@@ -73,6 +110,7 @@ def audio_socket(ws):
                     final_result = json.loads(recognizer.FinalResult())
                     if final_result.get('text'):
                         final_text = final_result['text']
+                        trace('sockets', 'voice_final', final_text)
                         print(f"Final: {final_text}\n")
                         ws.send(json.dumps({'type': 'final', 'text': final_text}))
                         voice_processor.process_command(final_text)
@@ -83,6 +121,7 @@ def audio_socket(ws):
                     result = json.loads(recognizer.Result())
                     if result.get('text'):
                         final_text = result['text']
+                        trace('sockets', 'voice_final', final_text)
                         print(f"\nFinal: {final_text}")
                         ws.send(json.dumps({'type': 'final', 'text': final_text}))
                         voice_processor.process_command(final_text)
@@ -123,6 +162,8 @@ def motor_socket(ws):
                 try:
                     data = json.loads(message)
                     msg_type = data.get('type')
+                    if msg_type != 'joystick':
+                        trace('sockets', 'ws_message', msg_type)
 
                     # Handle mode selection from client
                     if msg_type == 'set_mode':
@@ -163,6 +204,16 @@ def motor_socket(ws):
                                 motor_clients.discard(client)
                         continue
 
+                    # Handle velocity loop autotune (works in both modes)
+                    if msg_type == 'autotune':
+                        mode = data.get('mode', 'lifted')
+                        if mode not in ('lifted', 'floor'):
+                            mode = 'lifted'
+                        motor_interface.send_command(f"autotune {mode}")
+                        print(f"Autotune started ({mode})")
+                        ws.send(json.dumps({'type': 'autotune_started', 'mode': mode}))
+                        continue
+
                     # Handle commands based on control mode
                     match control_mode:
                         case 'joystick':
@@ -176,6 +227,8 @@ def motor_socket(ws):
                                 left_ns = max(1000000, min(2000000, int(left_ns)))
                                 right_ns = max(1000000, min(2000000, int(right_ns)))
 
+                                # Detail matches the command so the merger can pair it with cmd_write
+                                trace('sockets', 'ws_joystick', f"pulse {left_ns} {right_ns}")
                                 motor_interface.send_command(f"pulse {left_ns} {right_ns}")
 
                             elif msg_type == 'stop':
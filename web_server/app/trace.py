@@ -0,0 +1,36 @@
+"""
+Timeline trace events for end-to-end latency analysis.
+
+Events go to /dev/shm/asgc_trace_web.log in the same format as the C
+controller's trace (c_code/include/trace.h) and are merged into one timeline
+by tools/trace_merge.py. Timestamps use time.monotonic(), which is
+CLOCK_MONOTONIC on Linux - the same clock as get_time_sec() in the controller.
+
+Enable with ASGC_TRACE=1 (also passes --trace to the motor controller).
+"""
+import os
+import threading
+import time
+
+TRACE_ENABLED = os.environ.get('ASGC_TRACE') == '1'
+TRACE_PATH = '/dev/shm/asgc_trace_web.log'
+
+_lock = threading.Lock()
+_file = None
+
+if TRACE_ENABLED:
+    try:
+        _file = open(TRACE_PATH, 'w', buffering=1)  # Line buffered
+        print(f"Tracing to {TRACE_PATH}")
+    except OSError as e:
+        print(f"Warning: Could not open trace file {TRACE_PATH}: {e}")
+
+
+def trace(source, event, detail=''):
+    """Record one event. No-op unless tracing is enabled."""
+    if _file is None:
+        return
+    now = time.monotonic()
+    line = f"{now:.6f}\t{source}\t{event}\t{detail}\n"
+    with _lock:
+        _file.write(line)
@@ -1,4 +1,5 @@
 from .config import Config
+from .trace import trace
 
 class VoiceCommandProcessor:
     """
@@ -20,6 +21,7 @@ class VoiceCommandProcessor:
         words = command_text.split()
         
         print(f"[VOICE COMMAND] '{command_text}'")
+        trace('voice', 'voice_parse', command_text)
 
         queued_count = 0
         executed_immediate = False
@@ -50,6 +52,7 @@ class VoiceCommandProcessor:
     def _handle_immediate_command(self, word):
         """Executes immediate commands like stop, start, clear."""
         print(f"[VOICE] Executing immediate command: '{word}'")
+        trace('voice', 'voice_immediate', word)
         
         if word == 'clear':
             self.nav_controller.clear_queue()
@@ -81,6 +84,7 @@ class VoiceCommandProcessor:
                 # Assume it's a bucket color
                 self.nav_controller.go_to_bucket(target)
             
+            trace('voice', 'voice_queue', target)
             print(f"[VOICE] Successfully queued: {target}", flush=True)
             return True
         except Exception as e:
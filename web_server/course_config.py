@@ -8,7 +8,7 @@ Mirrors values from app/config.py for direct import usage.
 COURSE_WIDTH = 30
 COURSE_HEIGHT = 30
 
-# Bucket locations (feet)
+# Bucket locations (feet) - also landmarks in c_code/src/landmark.c
 BUCKETS = {
     'red': (0, 0),
     'yellow': (0, 30),
@@ -19,6 +19,16 @@ BUCKETS = {
 # Course center
 CENTER = (15, 15)
 
+# Navigation leg policies (goto x y arrival speed accel, see c_code/src/main.c).
+# Open legs cross the field at the speed slider (speed 0) and roll through their
+# end point; the last stretch to a bucket is capped at a slow speed and stops precisely.
+# A leg speed caps drives below the slider, never above it; turns always use the slider.
+# tools/plan_route.py exports these legs for asgc_batch_sim --legs.
+OPEN_LEG = {'arrival': 'pass', 'speed': 0.0, 'accel': 40.0}   # speed 0-1, accel PWM %/s
+APPROACH_LEG = {'arrival': 'precise', 'speed': 0.3, 'accel': 0.0}
+APPROACH_DISTANCE_FT = 4.0   # Final stretch to a bucket under APPROACH_LEG
+MIN_OPEN_LEG_FT = 4.0        # Shorter open stretches are not split off
+
 # Starting position
 START_POSITION = (0, 15)
 START_HEADING = 0  # Car points in +X direction (East)
@@ -0,0 +1,59 @@
+"""
+Gunicorn configuration for the ASGC web server (used by start_all.sh)
+
+    gunicorn -c gunicorn.conf.py web_server:app
+
+One worker process only: it owns the C motor controller subprocess, the
+navigation queue and the Vosk model, so a second worker would start a second
+controller fighting over the same motors. Concurrency comes from threads.
+"""
+import os
+
+bind = f"0.0.0.0:{os.environ.get('ASGC_WEB_PORT', '5000')}"
+
+workers = 1
+worker_class = 'gthread'
+
+# Every open WebSocket (/motor, /audio) holds a thread for its lifetime, so a
+# phone on the joystick page plus a laptop on the course view already use 2-4.
+# The rest serve the 30 Hz status polls and page loads.
+threads = int(os.environ.get('ASGC_WEB_THREADS', '32'))
+
+# Idle keep-alive connections wait in the worker's poller, not in a thread.
+# Browsers polling status every 33 ms reuse one TLS connection instead of
+# paying a handshake on the Pi per request.
+keepalive = 75
+
+# Worker heartbeat only (long-lived WebSockets are fine in gthread)
+timeout = 30
+graceful_timeout = 5
+
+# Never recycle the worker: that would restart the motor controller mid-run
+max_requests = 0
+
+# HTTPS is required for microphone access in the browser
+_here = os.path.dirname(os.path.abspath(__file__))
+if os.path.exists(os.path.join(_here, 'cert.pem')) and os.path.exists(os.path.join(_here, 'key.pem')):
+    certfile = os.path.join(_here, 'cert.pem')
+    keyfile = os.path.join(_here, 'key.pem')
+else:
+    print("\n⚠️  Warning: SSL certificates not found! Microphone may not work.")
+
+# Access log off: the status poll alone would be 30 lines per second per browser
+accesslog = None
+errorlog = '-'
+loglevel = 'info'
+capture_output = True
+
+
+def when_ready(server):
+    scheme = 'https' if 'certfile' in globals() else 'http'
+    print(f"Starting server on {scheme}://{bind}")
+    print("Connect to this address from your phone's browser.")
+
+
+def worker_exit(server, worker):
+    # Stop the motors and the C process with the worker that started them
+    from app import motor_interface
+    print("\nShutting down...")
+    motor_interface.stop()
@@ -4,8 +4,10 @@ Delegates all path planning and odometry to the C motor controller.
 """
 from typing import Optional, List
 import time
-from dataclasses import dataclass
+from dataclasses import dataclass, field
 from course_config import *
+from navigation_legs import NavigationLeg, plan_legs, leg_arrival, goto_command
+from app.trace import trace
 
 @dataclass
 class NavigationCommand:
@@ -13,6 +15,7 @@ class NavigationCommand:
     command_type: str  # 'bucket', 'center'
     target: str  # color name or 'center'
     position: tuple  # (x, y)
+    legs: List[NavigationLeg] = field(default_factory=list)  # Driven in order, last one ends at position
 
 class CoordinatedNavigationController:
     def __init__(self, send_command_callback):
@@ -27,6 +30,7 @@ class CoordinatedNavigationController:
         
         self.command_queue = []
         self.queue_running = False
+        self.leg_index = 0  # Leg of command_queue[0] being driven
 
     def get_position(self):
         """Return current status dictionary."""
@@ -55,19 +59,32 @@ class CoordinatedNavigationController:
         if pos:
             self.queue_command(NavigationCommand('bucket', color.upper(), pos))
 
+    def report_landmark(self, color: str):
+        """Tell C the robot is touching a bucket so it can correct its pose."""
+        if get_bucket_position(color):
+            self.send_command(f"landmark {color.lower()}")
+
     # --- Queue Management ---
     def queue_command(self, cmd):
+        # Legs start where the previous command ends (or at the robot)
+        start = self.command_queue[-1].position if self.command_queue else (self.x, self.y)
+        if not cmd.legs:
+            cmd.legs = plan_legs(cmd.command_type, start, cmd.position)
         self.command_queue.append(cmd)
+        trace('navigation', 'nav_queue', cmd.target)
         print(f"[NAV] Queued: {cmd.target}")
 
     def start_queue(self):
         if not self.queue_running and self.command_queue:
+            trace('navigation', 'queue_start', str(len(self.command_queue)))
             self.queue_running = True
+            self.leg_index = 0
             self._process_next_command()
             
     def clear_queue(self):
         self.command_queue = []
         self.queue_running = False
+        self.leg_index = 0
         self.send_command("stop") # Also stop C process
 
     def reset_position(self, x=None, y=None, heading=None):
@@ -88,9 +105,13 @@ class CoordinatedNavigationController:
             return
             
         cmd = self.command_queue[0]
+        leg = cmd.legs[self.leg_index]
+        arrival = leg_arrival(leg, len(self.command_queue) > 1)
         # Send GOTO to C
-        self.send_command(f"goto {cmd.position[0]:.2f} {cmd.position[1]:.2f}")
-        print(f"[NAV] Executing: {cmd.target} -> {cmd.position}")
+        trace('navigation', 'nav_execute', f"{cmd.target} {self.leg_index + 1}/{len(cmd.legs)}")
+        self.send_command(goto_command(leg, arrival))
+        print(f"[NAV] Executing: {cmd.target} leg {self.leg_index + 1}/{len(cmd.legs)} -> "
+              f"({leg.position[0]:.1f}, {leg.position[1]:.1f}) {arrival} speed {leg.speed:.2f} accel {leg.accel:.0f}")
 
     # --- Feedback Handling (called from motor_interface) ---
     
@@ -106,18 +127,26 @@ class CoordinatedNavigationController:
         
         # Check if we finished a move (transition from NON-IDLE to IDLE)
         if self.state != "IDLE" and new_state == "IDLE" and self.queue_running:
-            # Command finished
-            if self.command_queue:
-                finished = self.command_queue.pop(0)
-                print(f"[NAV] Finished: {finished.target}")
-                
-            # Trigger next
-            if self.command_queue:
-                # Small delay? C is fast enough.
+            if self.command_queue and self.leg_index + 1 < len(self.command_queue[0].legs):
+                # Leg finished: drive the next one of the same command
+                self.leg_index += 1
                 self._process_next_command()
             else:
-                self.queue_running = False
-                print("[NAV] Queue Complete")
+                # Command finished
+                self.leg_index = 0
+                if self.command_queue:
+                    finished = self.command_queue.pop(0)
+                    trace('navigation', 'nav_finished', finished.target)
+                    print(f"[NAV] Finished: {finished.target}")
+
+                # Trigger next
+                if self.command_queue:
+                    # Small delay? C is fast enough.
+                    self._process_next_command()
+                else:
+                    self.queue_running = False
+                    trace('navigation', 'queue_complete')
+                    print("[NAV] Queue Complete")
                 
         self.state = new_state
 
@@ -0,0 +1,47 @@
+"""
+Navigation Legs
+How a queued command is split into goto legs. Shared by the navigation queue
+(navigation_coordinated.py) and tools/plan_route.py, which feeds the same legs
+to asgc_batch_sim.
+"""
+from typing import Optional
+import math
+from dataclasses import dataclass
+from course_config import OPEN_LEG, APPROACH_LEG, APPROACH_DISTANCE_FT, MIN_OPEN_LEG_FT
+
+@dataclass
+class NavigationLeg:
+    """One goto sent to C, with its own limits"""
+    position: tuple  # (x, y)
+    arrival: Optional[str] = None  # 'precise', 'pass', None = decided when sent
+    speed: float = 0.0  # Speed cap 0-1 below the speed slider, 0 = slider only
+    accel: float = 0.0  # PWM ramp (percent/sec), 0 = none
+
+def plan_legs(command_type, start, position):
+    """Split a command into legs: open legs at the slider, a slow precise approach to buckets"""
+    if command_type != 'bucket':
+        # Center is open field; whether it is a waypoint depends on what follows
+        return [NavigationLeg(position, None, OPEN_LEG['speed'], OPEN_LEG['accel'])]
+
+    approach = NavigationLeg(position, **APPROACH_LEG)
+    dx, dy = position[0] - start[0], position[1] - start[1]
+    distance = math.hypot(dx, dy)
+    if distance < APPROACH_DISTANCE_FT + MIN_OPEN_LEG_FT:
+        return [approach]
+
+    # Open leg to a point APPROACH_DISTANCE_FT short of the bucket, on the line from start
+    scale = (distance - APPROACH_DISTANCE_FT) / distance
+    waypoint = (start[0] + dx * scale, start[1] + dy * scale)
+    return [NavigationLeg(waypoint, **OPEN_LEG), approach]
+
+def leg_arrival(leg, more_commands):
+    """Arrival mode to send for a leg"""
+    if leg.arrival is not None:
+        return leg.arrival
+    # Center is only a waypoint when more commands follow: roll through it.
+    # The last target is reached precisely (settle before judging)
+    return 'pass' if more_commands else 'precise'
+
+def goto_command(leg, arrival):
+    """The goto line sent to the C controller for a leg"""
+    return f"goto {leg.position[0]:.2f} {leg.position[1]:.2f} {arrival} {leg.speed:.2f} {leg.accel:.0f}"
@@ -16,6 +16,7 @@ let finalTranscript = '';
 let audioContext;
 let source;
 let processor;
+let voiceModelState = 'unknown'; // Speech model state reported by /audio
 
 // Queue Control Variables
 const queueStatus = document.getElementById('queueStatus');
@@ -109,14 +110,24 @@ function connectWebSocket() {
     ws.binaryType = 'arraybuffer';
 
     ws.onopen = () => {
-        voiceStatusText.textContent = 'Ready';
-        voiceStatusDot.classList.add('active');
-        voiceStartButton.disabled = false;
+        // Recording is enabled once the server reports the speech model is ready
+        voiceStatusText.textContent = 'Connecting...';
     };
 
     ws.onmessage = (event) => {
         const data = JSON.parse(event.data);
-        if (data.type === 'partial') {
+        if (data.type === 'status') {
+            voiceModelState = data.state;
+            if (data.state === 'ready') {
+                voiceStatusText.textContent = 'Ready';
+                voiceStatusDot.classList.add('active');
+                voiceStartButton.disabled = false;
+            } else if (data.state === 'warming_up') {
+                voiceStatusText.textContent = 'Voice warming up...';
+            } else if (data.state === 'failed') {
+                voiceStatusText.textContent = 'Voice unavailable';
+            }
+        } else if (data.type === 'partial') {
             transcriptEl.textContent = finalTranscript + data.text;
         } else if (data.type === 'final') {
             finalTranscript += data.text + ' ';
@@ -125,7 +136,9 @@ function connectWebSocket() {
     };
 
     ws.onclose = () => {
-        voiceStatusText.textContent = 'Disconnected';
+        if (voiceModelState !== 'failed') {
+            voiceStatusText.textContent = 'Disconnected';
+        }
         voiceStatusDot.classList.remove('active', 'recording');
         voiceStartButton.disabled = true;
         voiceStopButton.disabled = true;
@@ -141,8 +154,10 @@ function connectWebSocket() {
             audioContext.close();
             audioContext = null;
         }
-        // Auto-reconnect
-        setTimeout(connectWebSocket, 3000);
+        // Auto-reconnect (a failed model load won't recover without a server restart)
+        if (voiceModelState !== 'failed') {
+            setTimeout(connectWebSocket, 3000);
+        }
     };
 
     ws.onerror = (error) => {
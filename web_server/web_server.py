@@ -7,6 +7,7 @@ sys.path.append(os.path.dirname(__file__))
 
 app = create_app()
 
+# Development server only. start_all.sh serves `app` with gunicorn (gunicorn.conf.py).
 if __name__ == '__main__':
     print("Starting server on https://0.0.0.0:5000")
     print("Connect to this address from your phone's browser.")